@@ -9,6 +9,7 @@
 #include "EngineUtils.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "Toroid.h"
 
 ABuildingGameModeDemo::ABuildingGameModeDemo()
 {
@@ -157,7 +158,13 @@ void ABuildingGameModeDemo::SpawnCoreBuildings()
         TraceParams.bTraceComplex = false;
         TraceParams.bReturnPhysicalMaterial = false;
         
-        if (World->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_WorldStatic, TraceParams))
+        // Spawn points off the map are traced (and placed) at their canonical location
+        UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(World);
+        const bool bGroundHit = ToroidalWorld
+            ? ToroidalWorld->ToroidalLineTraceSingle(HitResult, TraceStart, TraceEnd, ECC_WorldStatic, TraceParams)
+            : World->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_WorldStatic, TraceParams);
+        
+        if (bGroundHit)
         {
             // Ground found, place building on top
             AdjustedSpawnLocation = HitResult.Location;
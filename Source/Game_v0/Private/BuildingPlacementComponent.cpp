@@ -65,6 +65,7 @@ void UBuildingPlacementComponent::ConfirmBuildingPlacement(){
     
 		if (PreviewBuilding){
 			PreviewBuilding->SetActorEnableCollision(true);
+			PreviewBuilding->SetOwningPlayer(GetOwnerPlayerState());
         
 			// Consume the resources after successful placement
 			UE_LOG(LogTemp, Warning, TEXT("About to call OnBuildingPlaced"));
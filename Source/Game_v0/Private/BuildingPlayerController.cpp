@@ -13,6 +13,7 @@
 #include "UnitCommand.h"
 #include "UnitController.h"
 #include "Camera/CameraActor.h"
+#include "Toroid.h"
 
 ABuildingPlayerController::ABuildingPlayerController()
 {
@@ -297,6 +298,30 @@ void ABuildingPlayerController::OnPlayerResourcesChanged(const TArray<FResource>
     }
 }
 
+void ABuildingPlayerController::Server_SubmitLockstepCommands_Implementation(const FLockstepSubmission& Submission)
+{
+    if (UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>())
+    {
+        Lockstep->ReceiveSubmission(this, Submission);
+    }
+}
+
+void ABuildingPlayerController::Client_StartLockstep_Implementation(const FLockstepStart& Start)
+{
+    if (UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>())
+    {
+        Lockstep->BeginSession(Start);
+    }
+}
+
+void ABuildingPlayerController::Client_ReceiveLockstepTurn_Implementation(const FLockstepTurn& Turn)
+{
+    if (UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>())
+    {
+        Lockstep->ReceiveTurn(Turn);
+    }
+}
+
 void ABuildingPlayerController::SetupInputComponent()
 {
     Super::SetupInputComponent();
@@ -643,8 +668,11 @@ void ABuildingPlayerController::HandleUnitCommand()
         FVector TargetLocation = GetWorldLocationUnderCursor();
         if (!TargetLocation.IsZero())
         {
-            UE_LOG(LogTemp, Log, TEXT("Commanding %d units to move to %s"), SelectedUnits.Num(), *TargetLocation.ToString());
-            CommandSelectedUnits(TargetLocation);
+            // Shift-click queues the move as another waypoint
+            const bool bQueue = IsInputKeyDown(EKeys::LeftShift) || IsInputKeyDown(EKeys::RightShift);
+            UE_LOG(LogTemp, Log, TEXT("Commanding %d units to move to %s%s"), SelectedUnits.Num(), *TargetLocation.ToString(),
+                   bQueue ? TEXT(" (queued)") : TEXT(""));
+            CommandSelectedUnits(TargetLocation, bQueue);
         }
     }
 }
@@ -680,20 +708,35 @@ void ABuildingPlayerController::DeselectAllUnits()
     UE_LOG(LogTemp, Log, TEXT("Deselected all units"));
 }
 
-void ABuildingPlayerController::CommandSelectedUnits(FVector TargetLocation)
+void ABuildingPlayerController::CommandSelectedUnits(FVector TargetLocation, bool bQueue)
 {
+    UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>();
+
     for (AUnitBase* Unit : SelectedUnits)
     {
         if (IsValid(Unit))
         {
+            FUnitCommand MoveCommand;
+            MoveCommand.CommandType = EUnitCommandType::Move;
+            MoveCommand.TargetLocation = TargetLocation;
+
+            // In lockstep the order goes to every peer instead of straight to the unit
+            if (Lockstep && Lockstep->SubmitCommand(Unit, MoveCommand, bQueue))
+            {
+                continue;
+            }
+
             AUnitController* UnitController = Cast<AUnitController>(Unit->GetController());
             if (UnitController)
             {
-                FUnitCommand MoveCommand;
-                MoveCommand.CommandType = EUnitCommandType::Move;
-                MoveCommand.TargetLocation = TargetLocation;
-                
-                UnitController->ExecuteCommand(MoveCommand);
+                if (bQueue)
+                {
+                    UnitController->QueueCommand(MoveCommand);
+                }
+                else
+                {
+                    UnitController->ExecuteCommand(MoveCommand);
+                }
                 UE_LOG(LogTemp, Log, TEXT("Commanded unit %s to move to %s"), *Unit->GetName(), *TargetLocation.ToString());
             }
         }
@@ -722,14 +765,19 @@ AUnitBase* ABuildingPlayerController::GetUnitUnderCursor()
     QueryParams.bTraceComplex = false;
     QueryParams.AddIgnoredActor(this->GetPawn());
     
+    // Across a seam the unit under the cursor is the real one on the far side.
+    // Visibility, not Pawn: unit capsules ignore the Pawn channel (see AUnitBase::SetupCollision)
     FHitResult HitResult;
-    bool bHit = GetWorld()->LineTraceSingleByChannel(
-        HitResult,
-        TraceStart,
-        TraceEnd,
-        ECC_Pawn,
-        QueryParams
-    );
+    UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+    bool bHit = ToroidalWorld
+        ? ToroidalWorld->ToroidalLineTraceSingle(HitResult, TraceStart, TraceEnd, ECC_Visibility, QueryParams)
+        : GetWorld()->LineTraceSingleByChannel(
+            HitResult,
+            TraceStart,
+            TraceEnd,
+            ECC_Visibility,
+            QueryParams
+        );
     
     if (bHit && HitResult.GetActor())
     {
@@ -770,14 +818,18 @@ FVector ABuildingPlayerController::GetWorldLocationUnderCursor()
         }
     }
     
+    // Ground past a seam resolves to its location on the canonical map
     FHitResult HitResult;
-    bool bHit = GetWorld()->LineTraceSingleByChannel(
-        HitResult,
-        TraceStart,
-        TraceEnd,
-        ECC_WorldStatic,
-        QueryParams
-    );
+    UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+    bool bHit = ToroidalWorld
+        ? ToroidalWorld->ToroidalLineTraceSingle(HitResult, TraceStart, TraceEnd, ECC_WorldStatic, QueryParams)
+        : GetWorld()->LineTraceSingleByChannel(
+            HitResult,
+            TraceStart,
+            TraceEnd,
+            ECC_WorldStatic,
+            QueryParams
+        );
     
     if (bHit)
     {
@@ -6,6 +6,9 @@
 #include "MyGameInstance.h"
 #include "GameFramework/PlayerController.h"
 #include "UnitBase.h"
+#include "Engine/Engine.h"
+#include "GameFramework/GameStateBase.h"
+#include "EngineUtils.h"
 
 ACustomPlayerState::ACustomPlayerState()
 {
@@ -14,6 +17,8 @@ ACustomPlayerState::ACustomPlayerState()
     bHasSelectedRace = false;
     ResourceDisplayWidget = nullptr;
     ResourceDisplayWidgetClass = nullptr;
+    PlayerUnits.Owner = this;
+    PlayerBuildings.Owner = this;
     
     // Enable replication
     bReplicates = true;
@@ -31,6 +36,7 @@ void ACustomPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& O
     DOREPLIFETIME(ACustomPlayerState, bHasSelectedRace);
     DOREPLIFETIME(ACustomPlayerState, RaceDisplayName);
     DOREPLIFETIME(ACustomPlayerState, PlayerUnits);
+    DOREPLIFETIME(ACustomPlayerState, PlayerBuildings);
 }
 
 void ACustomPlayerState::BeginPlay()
@@ -43,6 +49,9 @@ void ACustomPlayerState::BeginPlay()
     
     // Don't try to get race from Game Instance here anymore - let GameMode handle it
     // The GameMode will call SetPlayerRace after proper initialization
+
+    // Units may have been spawned before this player joined
+    AdoptTeamUnits();
     
     UE_LOG(LogTemp, Log, TEXT("PlayerState BeginPlay complete, waiting for GameMode initialization"));
 }
@@ -292,6 +301,52 @@ void ACustomPlayerState::InitializeResourcesFromRace()
                *Resource.ResourceName.ToString(), Resource.ResourceAmount, Resource.Weight);
     }
 }
+ACustomPlayerState* ACustomPlayerState::FindForTeam(const UObject* WorldContextObject, int32 InTeamID)
+{
+    const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+    const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+    if (!GameState)
+    {
+        return nullptr;
+    }
+
+    for (APlayerState* PlayerState : GameState->PlayerArray)
+    {
+        ACustomPlayerState* CustomState = Cast<ACustomPlayerState>(PlayerState);
+        if (CustomState && CustomState->TeamID == InTeamID)
+        {
+            return CustomState;
+        }
+    }
+    return nullptr;
+}
+
+void ACustomPlayerState::SetTeamID(int32 NewTeamID)
+{
+    if (HasAuthority() && TeamID != NewTeamID)
+    {
+        TeamID = NewTeamID;
+        AdoptTeamUnits();
+    }
+}
+
+void ACustomPlayerState::AdoptTeamUnits()
+{
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    // Each unit works out its own roster; this also drops units of the old team
+    for (TActorIterator<AUnitBase> It(GetWorld()); It; ++It)
+    {
+        if (It->GetTeamId() == TeamID || PlayerUnits.Contains(*It))
+        {
+            It->UpdateRoster();
+        }
+    }
+}
+
 void ACustomPlayerState::RegisterUnit(AUnitBase* Unit)
 {
     if (!Unit)
@@ -300,9 +355,9 @@ void ACustomPlayerState::RegisterUnit(AUnitBase* Unit)
         return;
     }
 
-    if (!PlayerUnits.Contains(Unit))
+    if (HasAuthority() && PlayerUnits.Add(Unit))
     {
-        PlayerUnits.Add(Unit);
+        OnUnitAdded.Broadcast(Unit);
         UE_LOG(LogTemp, Log, TEXT("Registered unit %s for Team %d (Total units: %d)"), 
                *Unit->GetName(), TeamID, PlayerUnits.Num());
     }
@@ -313,8 +368,9 @@ void ACustomPlayerState::UnregisterUnit(AUnitBase* Unit)
     if (!Unit)
         return;
 
-    if (PlayerUnits.Remove(Unit) > 0)
+    if (HasAuthority() && PlayerUnits.Remove(Unit))
     {
+        OnUnitRemoved.Broadcast(Unit);
         UE_LOG(LogTemp, Log, TEXT("Unregistered unit %s from Team %d (Remaining units: %d)"), 
                *Unit->GetName(), TeamID, PlayerUnits.Num());
     }
@@ -323,13 +379,42 @@ TArray<AUnitBase*> ACustomPlayerState::GetUnitsOfTeam(int32 InTeamID) const
 {
     TArray<AUnitBase*> TeamUnits;
     
-    for (AUnitBase* Unit : PlayerUnits)
+    for (const FPlayerUnitEntry& Entry : PlayerUnits.Items)
     {
-        if (Unit && Unit->GetTeamId() == InTeamID)
+        if (Entry.Unit && Entry.Unit->GetTeamId() == InTeamID)
         {
-            TeamUnits.Add(Unit);
+            TeamUnits.Add(Entry.Unit);
         }
     }
     
     return TeamUnits;
 }
+
+void ACustomPlayerState::RegisterBuilding(ABuildingBase* Building)
+{
+    if (!Building)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Attempted to register null building"));
+        return;
+    }
+
+    if (HasAuthority() && PlayerBuildings.Add(Building))
+    {
+        OnBuildingAdded.Broadcast(Building);
+        UE_LOG(LogTemp, Log, TEXT("Registered building %s for Team %d (Total buildings: %d)"),
+               *Building->GetName(), TeamID, PlayerBuildings.Num());
+    }
+}
+
+void ACustomPlayerState::UnregisterBuilding(ABuildingBase* Building)
+{
+    if (!Building)
+        return;
+
+    if (HasAuthority() && PlayerBuildings.Remove(Building))
+    {
+        OnBuildingRemoved.Broadcast(Building);
+        UE_LOG(LogTemp, Log, TEXT("Unregistered building %s from Team %d (Remaining buildings: %d)"),
+               *Building->GetName(), TeamID, PlayerBuildings.Num());
+    }
+}
@@ -1,9 +1,10 @@
 #include "ElfUnit.h"
+#include "UnitAssetCache.h"
 #include "Engine/AssetManager.h"
 
-AElfUnit::AElfUnit()
+AElfUnit::AElfUnit(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
 {
-    // Call parent constructor first
     
     // Explicitly set male elf mesh path (override parent's default)
     UnitMesh = TSoftObjectPtr<USkeletalMesh>(
@@ -91,6 +92,45 @@ TSoftObjectPtr<USkeletalMesh> AElfUnit::SelectElfMesh() const
     }
 }
 
+const FUnitCrowdVisual* AElfUnit::GetCrowdVisual(EUnitSex Sex) const
+{
+    const FUnitCrowdVisual& Visual = Sex == EUnitSex::Female ? FemaleCrowdVisual : MaleCrowdVisual;
+    return Visual.Mesh.IsNull() ? nullptr : &Visual;
+}
+
+void AElfUnit::GetAssetsToPreload(TArray<FSoftObjectPath>& OutPaths) const
+{
+    Super::GetAssetsToPreload(OutPaths);
+
+    if (!FemaleElfMesh.IsNull())
+    {
+        OutPaths.AddUnique(FemaleElfMesh.ToSoftObjectPath());
+    }
+    if (!FemaleAnimBP.IsNull())
+    {
+        OutPaths.AddUnique(FemaleAnimBP.ToSoftObjectPath());
+    }
+}
+
+void AElfUnit::ReinitializeFromPool(const FTransform& Transform, int32 InTeamId, EUnitSex InSex, AUnitSelectionManager* InSelectionManager)
+{
+    const EUnitSex PreviousSex = UnitSex;
+
+    Super::ReinitializeFromPool(Transform, InTeamId, InSex, InSelectionManager);
+
+    if (UnitSex != PreviousSex)
+    {
+        LoadElfMesh();
+
+        // Male elves run the parent's default AnimBP, which LoadElfAnimBP leaves alone
+        if (UnitSex == EUnitSex::Male)
+        {
+            GetMesh()->SetAnimInstanceClass(GetDefault<AUnitBase>()->GetMesh()->GetAnimClass());
+        }
+        LoadElfAnimBP();
+    }
+}
+
 TSoftClassPtr<UAnimInstance> AElfUnit::SelectElfAnimBP() const
 {
     switch (UnitSex)
@@ -110,8 +150,7 @@ void AElfUnit::LoadElfMesh()
     
     if (SelectedMesh.IsValid() || SelectedMesh.ToSoftObjectPath().IsValid())
     {
-        FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
-        Streamable.RequestAsyncLoad(SelectedMesh.ToSoftObjectPath(),
+        UUnitAssetCache::Load(this, SelectedMesh.ToSoftObjectPath(), FSimpleDelegate::CreateWeakLambda(this,
             [this, SelectedMesh]()
             {
                 if (SelectedMesh.IsValid() && GetMesh())
@@ -120,13 +159,14 @@ void AElfUnit::LoadElfMesh()
                     if (LoadedMesh)
                     {
                         GetMesh()->SetSkeletalMesh(LoadedMesh);
+                        MarkWrappedImagesDirty();
                         
                         UE_LOG(LogTemp, Log, TEXT("ElfUnit %s: Loaded %s mesh"), 
                             *GetName(), 
                             UnitSex == EUnitSex::Female ? TEXT("Female") : TEXT("Male"));
                     }
                 }
-            });
+            }));
     }
 }
 
@@ -137,8 +177,7 @@ void AElfUnit::LoadElfAnimBP()
     // Only load if we have a specific AnimBP for this sex (female)
     if (SelectedAnimBP.IsValid() || SelectedAnimBP.ToSoftObjectPath().IsValid())
     {
-        FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
-        Streamable.RequestAsyncLoad(SelectedAnimBP.ToSoftObjectPath(),
+        UUnitAssetCache::Load(this, SelectedAnimBP.ToSoftObjectPath(), FSimpleDelegate::CreateWeakLambda(this,
             [this, SelectedAnimBP]()
             {
                 if (SelectedAnimBP.IsValid() && GetMesh())
@@ -153,7 +192,7 @@ void AElfUnit::LoadElfAnimBP()
                             UnitSex == EUnitSex::Female ? TEXT("Female") : TEXT("Male"));
                     }
                 }
-            });
+            }));
     }
     else
     {
@@ -2,6 +2,7 @@
 
 #include "buildings/BigPotionWorkshop_Elves.h"
 #include"buildings/BlacksmithWorkshop_Elves.h"
+#include "ElfUnit.h"
 
 
 UElves::UElves()
@@ -13,6 +14,9 @@ UElves::UElves()
 	AvailableBuildings.Add(ABigPotionWorkshop_Elves::StaticClass());
 	AvailableBuildings.Add(ABlacksmithWorkshop_Elves::StaticClass());
 
+	// init units
+	UnitClasses.Add(AElfUnit::StaticClass());
+
 	// init resources
 	InitialResourceAmounts.Add(EResourceKind::water_small, 25);
 	InitialResourceAmounts.Add(EResourceKind::wood, 25);
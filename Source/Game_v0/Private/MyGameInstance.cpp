@@ -2,6 +2,7 @@
 #include "Engine/Engine.h"
 #include "Dwarves.h"
 #include "Elves.h"
+#include "UnitAssetCache.h"
 
 UMyGameInstance::UMyGameInstance()
 {
@@ -22,6 +23,12 @@ void UMyGameInstance::SetSelectedRace(ERaceNames Race)
         SelectedRaceClass = *FoundClass;
         UE_LOG(LogTemp, Warning, TEXT("Game Instance: Selected race class set to %s"),
                *SelectedRaceClass->GetName());
+
+        // Load unit assets while the player is still in menus
+        if (UUnitAssetCache* AssetCache = GetSubsystem<UUnitAssetCache>())
+        {
+            AssetCache->PreloadRace(SelectedRaceClass);
+        }
     }
     else
     {
@@ -39,6 +46,11 @@ void UMyGameInstance::SetSelectedRaceClass(TSubclassOf<URace_base> RaceClass)
 {
     SelectedRaceClass = RaceClass;
     bHasSelectedRace = (RaceClass != nullptr);
+
+    if (UUnitAssetCache* AssetCache = GetSubsystem<UUnitAssetCache>())
+    {
+        AssetCache->PreloadRace(RaceClass);
+    }
     
     UE_LOG(LogTemp, Warning, TEXT("Game Instance: Selected race class set to %s"), 
            RaceClass ? *RaceClass->GetName() : TEXT("None"));
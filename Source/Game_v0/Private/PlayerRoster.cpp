@@ -0,0 +1,170 @@
+#include "PlayerRoster.h"
+#include "CustomPlayerState.h"
+#include "UnitBase.h"
+#include "buildings/BuildingBase.h"
+
+// Units and buildings keep the same bookkeeping; only the entry's actor member
+// and the player state events differ.
+namespace PlayerRoster
+{
+    template<typename EntryType, typename ActorType>
+    using TActorMember = ActorType* EntryType::*;
+
+    template<typename DelegateType>
+    using TRosterEvent = DelegateType ACustomPlayerState::*;
+
+    template<typename EntryType, typename ActorType>
+    bool Add(FFastArraySerializer& List, TArray<EntryType>& Items, TMap<FObjectKey, int32>& Indices, TActorMember<EntryType, ActorType> Member, ActorType* Actor)
+    {
+        if (!Actor || Indices.Contains(FObjectKey(Actor)))
+        {
+            return false;
+        }
+
+        Indices.Add(FObjectKey(Actor), Items.Num());
+        EntryType& Entry = Items.AddDefaulted_GetRef();
+        Entry.*Member = Actor;
+        List.MarkItemDirty(Entry);
+        return true;
+    }
+
+    template<typename EntryType, typename ActorType>
+    bool Remove(FFastArraySerializer& List, TArray<EntryType>& Items, TMap<FObjectKey, int32>& Indices, TActorMember<EntryType, ActorType> Member, ActorType* Actor)
+    {
+        int32 Index = INDEX_NONE;
+        if (!Indices.RemoveAndCopyValue(FObjectKey(Actor), Index))
+        {
+            return false;
+        }
+
+        Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        if (Items.IsValidIndex(Index))
+        {
+            Indices.Add(FObjectKey(Items[Index].*Member), Index);
+        }
+        List.MarkArrayDirty();
+        return true;
+    }
+
+    template<typename EntryType, typename ActorType>
+    bool Contains(const TArray<EntryType>& Items, const TMap<FObjectKey, int32>& Indices, TActorMember<EntryType, ActorType> Member, const ActorType* Actor)
+    {
+        // Clients don't keep the index
+        if (Indices.Num() == Items.Num())
+        {
+            return Indices.Contains(FObjectKey(Actor));
+        }
+        return Items.ContainsByPredicate([Member, Actor](const EntryType& Entry) { return Entry.*Member == Actor; });
+    }
+
+    template<typename EntryType, typename ActorType>
+    TArray<ActorType*> GetActors(const TArray<EntryType>& Items, TActorMember<EntryType, ActorType> Member)
+    {
+        TArray<ActorType*> Actors;
+        Actors.Reserve(Items.Num());
+        for (const EntryType& Entry : Items)
+        {
+            if (Entry.*Member)
+            {
+                Actors.Add(Entry.*Member);
+            }
+        }
+        return Actors;
+    }
+
+    template<typename EntryType, typename ActorType, typename DelegateType>
+    void AnnounceAdd(EntryType& Entry, ACustomPlayerState* Owner, TActorMember<EntryType, ActorType> Member, TRosterEvent<DelegateType> Event)
+    {
+        // The actor may not have arrived yet; PostReplicatedChange tries again
+        if (Entry.*Member && Owner)
+        {
+            Entry.bAnnounced = true;
+            (Owner->*Event).Broadcast(Entry.*Member);
+        }
+    }
+
+    template<typename EntryType, typename ActorType, typename DelegateType>
+    void AnnounceRemove(const EntryType& Entry, ACustomPlayerState* Owner, TActorMember<EntryType, ActorType> Member, TRosterEvent<DelegateType> Event)
+    {
+        if (Entry.bAnnounced && Owner)
+        {
+            (Owner->*Event).Broadcast(Entry.*Member);
+        }
+    }
+}
+
+void FPlayerUnitEntry::PreReplicatedRemove(const FPlayerUnitList& InArraySerializer)
+{
+    PlayerRoster::AnnounceRemove(*this, InArraySerializer.Owner, &FPlayerUnitEntry::Unit, &ACustomPlayerState::OnUnitRemoved);
+}
+
+void FPlayerUnitEntry::PostReplicatedAdd(const FPlayerUnitList& InArraySerializer)
+{
+    PlayerRoster::AnnounceAdd(*this, InArraySerializer.Owner, &FPlayerUnitEntry::Unit, &ACustomPlayerState::OnUnitAdded);
+}
+
+void FPlayerUnitEntry::PostReplicatedChange(const FPlayerUnitList& InArraySerializer)
+{
+    if (!bAnnounced)
+    {
+        PostReplicatedAdd(InArraySerializer);
+    }
+}
+
+bool FPlayerUnitList::Add(AUnitBase* Unit)
+{
+    return PlayerRoster::Add(*this, Items, Indices, &FPlayerUnitEntry::Unit, Unit);
+}
+
+bool FPlayerUnitList::Remove(AUnitBase* Unit)
+{
+    return PlayerRoster::Remove(*this, Items, Indices, &FPlayerUnitEntry::Unit, Unit);
+}
+
+bool FPlayerUnitList::Contains(const AUnitBase* Unit) const
+{
+    return PlayerRoster::Contains(Items, Indices, &FPlayerUnitEntry::Unit, Unit);
+}
+
+TArray<AUnitBase*> FPlayerUnitList::GetUnits() const
+{
+    return PlayerRoster::GetActors(Items, &FPlayerUnitEntry::Unit);
+}
+
+void FPlayerBuildingEntry::PreReplicatedRemove(const FPlayerBuildingList& InArraySerializer)
+{
+    PlayerRoster::AnnounceRemove(*this, InArraySerializer.Owner, &FPlayerBuildingEntry::Building, &ACustomPlayerState::OnBuildingRemoved);
+}
+
+void FPlayerBuildingEntry::PostReplicatedAdd(const FPlayerBuildingList& InArraySerializer)
+{
+    PlayerRoster::AnnounceAdd(*this, InArraySerializer.Owner, &FPlayerBuildingEntry::Building, &ACustomPlayerState::OnBuildingAdded);
+}
+
+void FPlayerBuildingEntry::PostReplicatedChange(const FPlayerBuildingList& InArraySerializer)
+{
+    if (!bAnnounced)
+    {
+        PostReplicatedAdd(InArraySerializer);
+    }
+}
+
+bool FPlayerBuildingList::Add(ABuildingBase* Building)
+{
+    return PlayerRoster::Add(*this, Items, Indices, &FPlayerBuildingEntry::Building, Building);
+}
+
+bool FPlayerBuildingList::Remove(ABuildingBase* Building)
+{
+    return PlayerRoster::Remove(*this, Items, Indices, &FPlayerBuildingEntry::Building, Building);
+}
+
+bool FPlayerBuildingList::Contains(const ABuildingBase* Building) const
+{
+    return PlayerRoster::Contains(Items, Indices, &FPlayerBuildingEntry::Building, Building);
+}
+
+TArray<ABuildingBase*> FPlayerBuildingList::GetBuildings() const
+{
+    return PlayerRoster::GetActors(Items, &FPlayerBuildingEntry::Building);
+}
@@ -1,8 +1,23 @@
 #include "Toroid.h"
+#include "ToroidalMath.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Math/UnrealMathUtility.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+
+namespace
+{
+    // Dirty objects handed to one worker at a time during the wrap tick
+    constexpr int32 WrapChunkSize = 256;
+
+    // Managers that have begun play, for UToroidalWorldManager::Get
+    TArray<TWeakObjectPtr<UToroidalWorldManager>> ActiveManagers;
+}
 
 UToroidalWorldManager::UToroidalWorldManager()
 {
@@ -13,32 +28,193 @@ UToroidalWorldManager::UToroidalWorldManager()
     WorldHeight = 10000.0f;
     WrapThreshold = 1000.0f; // Objects within 1000 units of edge will be wrapped
     WorldCenter = FVector(0.0f, 0.0f, 0.0f);
+    SpatialCellSize = 500.0f;
+    MaxPooledGhostsPerClass = 32;
+    GhostMode = EToroidalGhostMode::MeshProxy;
+    bCullGhostsToView = true;
+    ViewCullMargin = 2000.0f;
+    MaxViewDistance = 20000.0f;
+    bUseFixedPointCoordinates = false;
+    ViewBounds = FBox2D(ForceInit);
+    EvaluatedViewBounds = FBox2D(ForceInit);
 }
 
 void UToroidalWorldManager::BeginPlay()
 {
     Super::BeginPlay();
     
+    RebuildSpatialGrid();
+    RebuildFixedSpace();
+    ActiveManagers.AddUnique(this);
+    
     UE_LOG(LogTemp, Log, TEXT("ToroidalWorldManager initialized with dimensions: %fx%f"), WorldWidth, WorldHeight);
 }
 
+void UToroidalWorldManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    ActiveManagers.Remove(this);
+    
+    // Pooled ghosts are owned by the level, make sure they go away with us
+    for (TPair<UClass*, FToroidalGhostPool>& Pair : GhostPools)
+    {
+        for (TWeakObjectPtr<AActor>& Ghost : Pair.Value.FreeGhosts)
+        {
+            if (Ghost.IsValid())
+            {
+                Ghost->Destroy();
+            }
+        }
+    }
+    GhostPools.Empty();
+    
+    // Proxy components are owned by our actor and go away with it
+    ProxyBatches.Empty();
+    FreeSkeletalProxies.Empty();
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+UToroidalWorldManager* UToroidalWorldManager::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    if (!World)
+    {
+        return nullptr;
+    }
+    
+    for (const TWeakObjectPtr<UToroidalWorldManager>& Manager : ActiveManagers)
+    {
+        if (Manager.IsValid() && Manager->GetWorld() == World)
+        {
+            return Manager.Get();
+        }
+    }
+    
+    return nullptr;
+}
+
 void UToroidalWorldManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     
-    // Update all tracked objects
-    for (FWrappedObject& WrappedObj : TrackedObjects)
+    // May dirty objects near the edges if the camera moved
+    UpdateViewBounds();
+    
+    ProcessDirtyObjects();
+}
+
+void UToroidalWorldManager::ProcessDirtyObjects()
+{
+    // Only actors whose root moved since last tick need re-evaluation.
+    // Everything else (buildings, idle units) keeps its cached edge status.
+    if (DirtyHandles.Num() == 0)
+    {
+        return;
+    }
+    
+    // Gather the live dirty objects and their raw positions. Reading actor
+    // state has to happen here on the game thread.
+    int32 NumCommands = 0;
+    ScratchX.Reset();
+    ScratchY.Reset();
+    for (const FToroidalHandle& Handle : DirtyHandles)
     {
-        if (WrappedObj.OriginalActor.IsValid())
+        const int32 Index = TrackedObjects.GetDenseIndex(Handle);
+        if (Index == INDEX_NONE || !TrackedObjects.DirtyFlags[Index])
+        {
+            continue;
+        }
+        TrackedObjects.DirtyFlags[Index] = false;
+        
+        AActor* Actor = TrackedObjects.Actors[Index].Get();
+        if (!Actor)
         {
-            UpdateWrappedInstances(WrappedObj);
+            continue;
         }
+        
+        // Command buffers are reused across ticks to keep their position arrays
+        if (WrapCommands.Num() <= NumCommands)
+        {
+            WrapCommands.AddDefaulted();
+        }
+        FToroidalWrapCommand& Command = WrapCommands[NumCommands++];
+        Command.Index = Index;
+        Command.Handle = Handle;
+        Command.CurrentLocation = Actor->GetActorLocation();
+        
+        const FToroidalCoordinate Position = WorldToToroidal(Command.CurrentLocation);
+        ScratchX.Add(Position.X);
+        ScratchY.Add(Position.Y);
+        TrackedObjects.PositionZ[Index] = Position.Z;
     }
+    DirtyHandles.Reset();
     
-    // Clean up invalid objects
-    TrackedObjects.RemoveAll([](const FWrappedObject& Obj) {
-        return !Obj.OriginalActor.IsValid();
+    // Normalization, edge detection and ghost positions are pure math.
+    // Each worker takes a run of objects, normalizes it with SIMD and fills
+    // in their commands. Every object is touched by exactly one worker.
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumCommands, WrapChunkSize);
+    ParallelFor(TEXT("ToroidalWrapEvaluation"), NumChunks, 1, [this, NumCommands](int32 ChunkIndex)
+    {
+        const int32 First = ChunkIndex * WrapChunkSize;
+        const int32 Count = FMath::Min(WrapChunkSize, NumCommands - First);
+        
+        FToroidalMath::NormalizeBatch(
+            TArrayView<float>(ScratchX).Slice(First, Count),
+            TArrayView<float>(ScratchY).Slice(First, Count),
+            WorldWidth, WorldHeight);
+        
+        for (int32 i = First; i < First + Count; ++i)
+        {
+            FToroidalWrapCommand& Command = WrapCommands[i];
+            TrackedObjects.PositionX[Command.Index] = ScratchX[i];
+            TrackedObjects.PositionY[Command.Index] = ScratchY[i];
+            
+            BuildWrapCommand(FToroidalCoordinate(ScratchX[i], ScratchY[i], TrackedObjects.PositionZ[Command.Index]), Command);
+        }
     });
+    
+    // Wrapping an actor moves it; that is our own doing and not a new change
+    TGuardValue<bool> ApplyingWrapGuard(bApplyingWrap, true);
+    
+    Stats.ObjectsEvaluated += NumCommands;
+    
+    // Moving an actor or spawning a ghost can end up destroying a tracked
+    // actor (overlaps, gameplay), which swaps another into its slot; each
+    // command finds its object again by handle
+    for (int32 i = 0; i < NumCommands; ++i)
+    {
+        ApplyWrapCommand(WrapCommands[i]);
+    }
+}
+
+void UToroidalWorldManager::MarkActorDirty(AActor* Actor)
+{
+    if (const FToroidalHandle* Handle = ActorToHandle.Find(Actor))
+    {
+        MarkIndexDirty(TrackedObjects.GetDenseIndex(*Handle));
+    }
+}
+
+void UToroidalWorldManager::MarkIndexDirty(int32 Index)
+{
+    if (Index != INDEX_NONE && !TrackedObjects.DirtyFlags[Index])
+    {
+        TrackedObjects.DirtyFlags[Index] = true;
+        DirtyHandles.Add(TrackedObjects.GetHandle(Index));
+    }
+}
+
+void UToroidalWorldManager::OnTrackedTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+    if (!bApplyingWrap && UpdatedComponent)
+    {
+        MarkActorDirty(UpdatedComponent->GetOwner());
+    }
+}
+
+void UToroidalWorldManager::OnTrackedActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+    UnregisterActor(Actor);
 }
 
 FToroidalCoordinate UToroidalWorldManager::WorldToToroidal(const FVector& WorldPosition) const
@@ -54,23 +230,13 @@ FVector UToroidalWorldManager::ToroidalToWorld(const FToroidalCoordinate& Toroid
 
 FToroidalCoordinate UToroidalWorldManager::NormalizeToroidalCoordinate(const FToroidalCoordinate& Coordinate) const
 {
-    FToroidalCoordinate Normalized = Coordinate;
-    
-    // Wrap X coordinate
-    float HalfWidth = WorldWidth * 0.5f;
-    while (Normalized.X > HalfWidth)
-        Normalized.X -= WorldWidth;
-    while (Normalized.X < -HalfWidth)
-        Normalized.X += WorldWidth;
-    
-    // Wrap Y coordinate
-    float HalfHeight = WorldHeight * 0.5f;
-    while (Normalized.Y > HalfHeight)
-        Normalized.Y -= WorldHeight;
-    while (Normalized.Y < -HalfHeight)
-        Normalized.Y += WorldHeight;
-    
-    return Normalized;
+    // Floor based wrap, constant cost no matter how far outside the coordinate
+    // is. Also in fixed point mode: a float -> fixed -> float round trip only
+    // costs more, and exact results come from the fixed point API itself.
+    return FToroidalCoordinate(
+        FToroidalMath::Wrap(Coordinate.X, WorldWidth),
+        FToroidalMath::Wrap(Coordinate.Y, WorldHeight),
+        Coordinate.Z);
 }
 
 void UToroidalWorldManager::RegisterActor(AActor* Actor)
@@ -81,22 +247,33 @@ void UToroidalWorldManager::RegisterActor(AActor* Actor)
     }
     
     // Check if already registered
-    for (const FWrappedObject& Obj : TrackedObjects)
+    if (const FToroidalHandle* ExistingHandle = ActorToHandle.Find(Actor))
     {
-        if (Obj.OriginalActor == Actor)
+        if (TrackedObjects.IsValid(*ExistingHandle))
         {
             return; // Already registered
         }
     }
     
-    FToroidalCoordinate ToroidalPos = WorldToToroidal(Actor->GetActorLocation());
-    FWrappedObject NewWrappedObject(Actor, ToroidalPos);
+    FToroidalCoordinate ToroidalPos = NormalizeToroidalCoordinate(WorldToToroidal(Actor->GetActorLocation()));
     
-    int32 Index = TrackedObjects.Add(NewWrappedObject);
-    ActorToIndexMap.Add(Actor, Index);
+    const FToroidalHandle Handle = TrackedObjects.Add(Actor);
+    const int32 Index = TrackedObjects.GetDenseIndex(Handle);
+    TrackedObjects.PositionX[Index] = ToroidalPos.X;
+    TrackedObjects.PositionY[Index] = ToroidalPos.Y;
+    TrackedObjects.PositionZ[Index] = ToroidalPos.Z;
+    ActorToHandle.Add(Actor, Handle);
+    SpatialGrid.AddOrUpdate(Actor, ToroidalPos);
+    
+    // Get told when the actor moves or goes away instead of polling every tick
+    if (USceneComponent* Root = Actor->GetRootComponent())
+    {
+        TrackedObjects.TransformUpdatedHandles[Index] = Root->TransformUpdated.AddUObject(this, &UToroidalWorldManager::OnTrackedTransformUpdated);
+    }
+    Actor->OnEndPlay.AddDynamic(this, &UToroidalWorldManager::OnTrackedActorEndPlay);
     
     // Create initial wrapped instances if needed
-    CreateWrappedInstances(TrackedObjects[Index]);
+    CreateWrappedInstances(Index);
     
     UE_LOG(LogTemp, Log, TEXT("Registered actor %s for toroidal wrapping"), *Actor->GetName());
 }
@@ -108,56 +285,51 @@ void UToroidalWorldManager::UnregisterActor(AActor* Actor)
         return;
     }
     
-    int32* IndexPtr = ActorToIndexMap.Find(Actor);
-    if (IndexPtr)
+    FToroidalHandle Handle;
+    if (ActorToHandle.RemoveAndCopyValue(Actor, Handle))
     {
-        int32 Index = *IndexPtr;
-        if (TrackedObjects.IsValidIndex(Index))
-        {
-            CleanupWrappedInstances(TrackedObjects[Index]);
-            TrackedObjects.RemoveAt(Index);
-        }
-        ActorToIndexMap.Remove(Actor);
-        
-        // Update indices in map
-        for (auto& Pair : ActorToIndexMap)
+        const int32 Index = TrackedObjects.GetDenseIndex(Handle);
+        if (Index != INDEX_NONE)
         {
-            if (Pair.Value > Index)
+            if (USceneComponent* Root = Actor->GetRootComponent())
             {
-                Pair.Value--;
+                Root->TransformUpdated.Remove(TrackedObjects.TransformUpdatedHandles[Index]);
             }
+            CleanupWrappedInstances(Index);
+            
+            // Swap-and-pop; any queued dirty handle for it simply goes stale
+            TrackedObjects.Remove(Handle);
         }
+        Actor->OnEndPlay.RemoveDynamic(this, &UToroidalWorldManager::OnTrackedActorEndPlay);
+        SpatialGrid.Remove(Actor);
     }
 }
 
 void UToroidalWorldManager::UpdateActorWrapping(AActor* Actor)
 {
-    if (!Actor)
+    const FToroidalHandle* Handle = ActorToHandle.Find(Actor);
+    if (!Handle)
     {
         return;
     }
     
-    int32* IndexPtr = ActorToIndexMap.Find(Actor);
-    if (IndexPtr && TrackedObjects.IsValidIndex(*IndexPtr))
+    const int32 Index = TrackedObjects.GetDenseIndex(*Handle);
+    if (Index != INDEX_NONE)
     {
-        FWrappedObject& WrappedObj = TrackedObjects[*IndexPtr];
-        
-        // Update canonical position
-        FToroidalCoordinate NewPos = WorldToToroidal(Actor->GetActorLocation());
-        WrappedObj.CanonicalPosition = NormalizeToroidalCoordinate(NewPos);
-        
-        // Update actor position to normalized world position
-        FVector NormalizedWorldPos = ToroidalToWorld(WrappedObj.CanonicalPosition);
-        if (FVector::Dist(Actor->GetActorLocation(), NormalizedWorldPos) > 0.1f)
-        {
-            Actor->SetActorLocation(NormalizedWorldPos);
-        }
+        // Brought up to date right here, no need to look at it again next tick
+        TGuardValue<bool> ApplyingWrapGuard(bApplyingWrap, true);
+        TrackedObjects.DirtyFlags[Index] = false;
         
-        // Update wrapped instances
-        UpdateWrappedInstances(WrappedObj);
+        UpdateWrappedInstances(Index);
     }
 }
 
+FToroidalHandle UToroidalWorldManager::GetActorHandle(AActor* Actor) const
+{
+    const FToroidalHandle* Handle = ActorToHandle.Find(Actor);
+    return Handle ? *Handle : FToroidalHandle();
+}
+
 void UToroidalWorldManager::WrapCameraPosition(AActor* CameraActor)
 {
     if (!CameraActor)
@@ -182,247 +354,1192 @@ void UToroidalWorldManager::WrapCameraPosition(AActor* CameraActor)
 
 float UToroidalWorldManager::GetToroidalDistance(const FVector& Position1, const FVector& Position2) const
 {
-    FToroidalCoordinate Pos1 = NormalizeToroidalCoordinate(WorldToToroidal(Position1));
-    FToroidalCoordinate Pos2 = NormalizeToroidalCoordinate(WorldToToroidal(Position2));
-    
-    // Calculate distance considering wrapping
-    float DX = FMath::Abs(Pos1.X - Pos2.X);
-    float DY = FMath::Abs(Pos1.Y - Pos2.Y);
-    float DZ = FMath::Abs(Pos1.Z - Pos2.Z);
-    
-    // Consider wrapping for X and Y
-    DX = FMath::Min(DX, WorldWidth - DX);
-    DY = FMath::Min(DY, WorldHeight - DY);
-    
-    return FMath::Sqrt(DX * DX + DY * DY + DZ * DZ);
+    return GetToroidalDelta(Position1, Position2).Size();
 }
 
 FVector UToroidalWorldManager::GetToroidalDirection(const FVector& From, const FVector& To) const
 {
-    FToroidalCoordinate FromPos = NormalizeToroidalCoordinate(WorldToToroidal(From));
-    FToroidalCoordinate ToPos = NormalizeToroidalCoordinate(WorldToToroidal(To));
+    return GetToroidalDelta(From, To).GetSafeNormal();
+}
+
+FVector UToroidalWorldManager::GetToroidalDelta(const FVector& From, const FVector& To) const
+{
+    // Float even with fixed point on: the inputs are floats, so a round trip
+    // through fixed point would only cost more. Exact deltas are for callers
+    // that keep fixed coordinates (GetFixedSpace).
+    // WorldCenter cancels out and wrapping the difference makes normalizing
+    // both inputs unnecessary. Z doesn't wrap.
+    return FVector(
+        FToroidalMath::Wrap(To.X - From.X, WorldWidth),
+        FToroidalMath::Wrap(To.Y - From.Y, WorldHeight),
+        To.Z - From.Z);
+}
+
+bool UToroidalWorldManager::GetSeamCrossing(const FVector& From, const FVector& To, float Inset, FVector& OutExit, FVector& OutEntry) const
+{
+    const FToroidalCoordinate Start = NormalizeToroidalCoordinate(WorldToToroidal(From));
+    const FVector Delta = GetToroidalDelta(From, To);
     
-    FVector Direction;
+    const float HalfWidth = WorldWidth * 0.5f;
+    const float HalfHeight = WorldHeight * 0.5f;
     
-    // Calculate X direction considering wrapping
-    float DX = ToPos.X - FromPos.X;
-    if (FMath::Abs(DX) > WorldWidth * 0.5f)
+    // Fraction of the route travelled when it hits each seam
+    float TimeX = BIG_NUMBER;
+    if (!FMath::IsNearlyZero(Delta.X))
     {
-        DX = DX > 0 ? DX - WorldWidth : DX + WorldWidth;
+        TimeX = ((Delta.X > 0.0f ? HalfWidth : -HalfWidth) - Start.X) / Delta.X;
     }
-    Direction.X = DX;
-    
-    // Calculate Y direction considering wrapping
-    float DY = ToPos.Y - FromPos.Y;
-    if (FMath::Abs(DY) > WorldHeight * 0.5f)
+    float TimeY = BIG_NUMBER;
+    if (!FMath::IsNearlyZero(Delta.Y))
     {
-        DY = DY > 0 ? DY - WorldHeight : DY + WorldHeight;
+        TimeY = ((Delta.Y > 0.0f ? HalfHeight : -HalfHeight) - Start.Y) / Delta.Y;
     }
-    Direction.Y = DY;
     
-    // Z doesn't wrap
-    Direction.Z = ToPos.Z - FromPos.Z;
-    
-    return Direction.GetSafeNormal();
-}
-
-bool UToroidalWorldManager::IsActorNearEdge(AActor* Actor) const
-{
-    if (!Actor)
+    const float Time = FMath::Min(TimeX, TimeY);
+    if (Time >= 1.0f)
     {
-        return false;
+        return false; // Stays on the map
     }
     
-    FToroidalCoordinate ToroidalPos = WorldToToroidal(Actor->GetActorLocation());
-    
-    float HalfWidth = WorldWidth * 0.5f;
-    float HalfHeight = WorldHeight * 0.5f;
+    const float InsetX = FMath::Min(Inset, HalfWidth);
+    const float InsetY = FMath::Min(Inset, HalfHeight);
+    FToroidalCoordinate Exit(
+        FMath::Clamp(Start.X + Delta.X * Time, -HalfWidth + InsetX, HalfWidth - InsetX),
+        FMath::Clamp(Start.Y + Delta.Y * Time, -HalfHeight + InsetY, HalfHeight - InsetY),
+        Start.Z);
+    FToroidalCoordinate Entry = Exit;
     
-    bool NearLeftRight = (FMath::Abs(ToroidalPos.X - HalfWidth) < WrapThreshold) || 
-                        (FMath::Abs(ToroidalPos.X + HalfWidth) < WrapThreshold);
-    bool NearTopBottom = (FMath::Abs(ToroidalPos.Y - HalfHeight) < WrapThreshold) || 
-                        (FMath::Abs(ToroidalPos.Y + HalfHeight) < WrapThreshold);
+    // Only the seam hit first is crossed here; a corner route crosses the
+    // other one on its next leg
+    if (TimeX <= TimeY)
+    {
+        Entry.X = -Exit.X;
+    }
+    else
+    {
+        Entry.Y = -Exit.Y;
+    }
     
-    return NearLeftRight || NearTopBottom;
+    OutExit = ToroidalToWorld(Exit);
+    OutEntry = ToroidalToWorld(Entry);
+    return true;
 }
 
-TArray<FVector> UToroidalWorldManager::GetWrappedPositions(const FVector& OriginalPosition) const
+void UToroidalWorldManager::SplitQueryAtSeams(const FVector& Start, const FVector& End, TArray<FToroidalQueryPiece>& OutPieces) const
 {
-    TArray<FVector> Positions;
-    FToroidalCoordinate ToroidalPos = NormalizeToroidalCoordinate(WorldToToroidal(OriginalPosition));
-    
-    float HalfWidth = WorldWidth * 0.5f;
-    float HalfHeight = WorldHeight * 0.5f;
+    const float HalfWidth = WorldWidth * 0.5f;
+    const float HalfHeight = WorldHeight * 0.5f;
     
-    // Check if near edges and add wrapped positions
-    bool NearLeft = ToroidalPos.X < (-HalfWidth + WrapThreshold);
-    bool NearRight = ToroidalPos.X > (HalfWidth - WrapThreshold);
-    bool NearBottom = ToroidalPos.Y < (-HalfHeight + WrapThreshold);
-    bool NearTop = ToroidalPos.Y > (HalfHeight - WrapThreshold);
+    // Walk the segment in toroidal space starting from the canonical start
+    FVector Position = NormalizeToroidalCoordinate(WorldToToroidal(Start)).ToVector();
+    const FVector Delta = End - Start;
     
-    // Right edge wrapping
-    if (NearRight)
+    // A long query can cross a few worlds, but never loop forever
+    const int32 MaxPieces = 16;
+    float Time = 0.0f;
+    while (Time < 1.0f && OutPieces.Num() < MaxPieces)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.X -= WorldWidth;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        // Fraction of the whole query until the next seam on each axis
+        float StepX = BIG_NUMBER;
+        if (Delta.X > KINDA_SMALL_NUMBER)
+        {
+            StepX = (HalfWidth - Position.X) / Delta.X;
+        }
+        else if (Delta.X < -KINDA_SMALL_NUMBER)
+        {
+            StepX = (-HalfWidth - Position.X) / Delta.X;
+        }
+        
+        float StepY = BIG_NUMBER;
+        if (Delta.Y > KINDA_SMALL_NUMBER)
+        {
+            StepY = (HalfHeight - Position.Y) / Delta.Y;
+        }
+        else if (Delta.Y < -KINDA_SMALL_NUMBER)
+        {
+            StepY = (-HalfHeight - Position.Y) / Delta.Y;
+        }
+        
+        const float Step = FMath::Max(FMath::Min3(StepX, StepY, 1.0f - Time), 0.0f);
+        const FVector PieceEnd = Position + Delta * Step;
+        
+        if (Step > 0.0f)
+        {
+            FToroidalQueryPiece& Piece = OutPieces.AddDefaulted_GetRef();
+            Piece.Start = Position + WorldCenter;
+            Piece.End = PieceEnd + WorldCenter;
+            Piece.StartTime = Time;
+            Piece.EndTime = Time + Step;
+        }
+        
+        Time += Step;
+        Position = PieceEnd;
+        
+        // Reappear on the opposite edge of whichever seam was hit
+        if (Time < 1.0f)
+        {
+            if (StepX <= Step)
+            {
+                Position.X += Delta.X > 0.0f ? -WorldWidth : WorldWidth;
+            }
+            if (StepY <= Step)
+            {
+                Position.Y += Delta.Y > 0.0f ? -WorldHeight : WorldHeight;
+            }
+        }
     }
+}
+
+void UToroidalWorldManager::GetSeamImageOffsets(const FBox& Bounds, TArray<FVector, TInlineAllocator<4>>& OutOffsets) const
+{
+    const FVector Min = Bounds.Min - WorldCenter;
+    const FVector Max = Bounds.Max - WorldCenter;
+    const float HalfWidth = WorldWidth * 0.5f;
+    const float HalfHeight = WorldHeight * 0.5f;
     
-    // Left edge wrapping
-    if (NearLeft)
+    // Shifting by a world size brings what sticks out over one edge in over the other
+    float OffsetsX[2] = { 0.0f, 0.0f };
+    int32 NumX = 1;
+    if (Max.X > HalfWidth)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.X += WorldWidth;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        OffsetsX[NumX++] = -WorldWidth;
     }
-    
-    // Top edge wrapping
-    if (NearTop)
+    else if (Min.X < -HalfWidth)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.Y -= WorldHeight;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        OffsetsX[NumX++] = WorldWidth;
     }
     
-    // Bottom edge wrapping
-    if (NearBottom)
+    float OffsetsY[2] = { 0.0f, 0.0f };
+    int32 NumY = 1;
+    if (Max.Y > HalfHeight)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.Y += WorldHeight;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        OffsetsY[NumY++] = -WorldHeight;
     }
-    
-    // Corner wrapping
-    if (NearRight && NearTop)
+    else if (Min.Y < -HalfHeight)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.X -= WorldWidth;
-        WrappedPos.Y -= WorldHeight;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        OffsetsY[NumY++] = WorldHeight;
     }
     
-    if (NearRight && NearBottom)
+    for (int32 IndexY = 0; IndexY < NumY; ++IndexY)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.X -= WorldWidth;
-        WrappedPos.Y += WorldHeight;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        for (int32 IndexX = 0; IndexX < NumX; ++IndexX)
+        {
+            OutOffsets.Add(FVector(OffsetsX[IndexX], OffsetsY[IndexY], 0.0f));
+        }
     }
-    
-    if (NearLeft && NearTop)
+}
+
+bool UToroidalWorldManager::ToroidalLineTraceSingle(FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params) const
+{
+    UWorld* World = GetWorld();
+    if (!World)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.X += WorldWidth;
-        WrappedPos.Y -= WorldHeight;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        return false;
     }
     
-    if (NearLeft && NearBottom)
+    TArray<FToroidalQueryPiece> Pieces;
+    SplitQueryAtSeams(Start, End, Pieces);
+    
+    const float TotalLength = FVector::Dist(Start, End);
+    for (const FToroidalQueryPiece& Piece : Pieces)
     {
-        FToroidalCoordinate WrappedPos = ToroidalPos;
-        WrappedPos.X += WorldWidth;
-        WrappedPos.Y += WorldHeight;
-        Positions.Add(ToroidalToWorld(WrappedPos));
+        // Pieces are in order, so the first one that hits has the closest hit
+        if (World->LineTraceSingleByChannel(OutHit, Piece.Start, Piece.End, TraceChannel, Params))
+        {
+            OutHit.Time = FMath::Lerp(Piece.StartTime, Piece.EndTime, OutHit.Time);
+            OutHit.Distance = OutHit.Time * TotalLength;
+            return true;
+        }
     }
     
-    return Positions;
+    return false;
 }
 
-void UToroidalWorldManager::SetWorldDimensions(float Width, float Height)
+bool UToroidalWorldManager::ToroidalLineTraceMulti(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params) const
 {
-    WorldWidth = Width;
-    WorldHeight = Height;
+    OutHits.Reset();
     
-    // Update all existing objects
-    for (FWrappedObject& WrappedObj : TrackedObjects)
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return false;
+    }
+    
+    TArray<FToroidalQueryPiece> Pieces;
+    SplitQueryAtSeams(Start, End, Pieces);
+    
+    const float TotalLength = FVector::Dist(Start, End);
+    TArray<FHitResult> PieceHits;
+    for (const FToroidalQueryPiece& Piece : Pieces)
     {
-        UpdateWrappedInstances(WrappedObj);
+        const bool bBlocked = World->LineTraceMultiByChannel(PieceHits, Piece.Start, Piece.End, TraceChannel, Params);
+        for (FHitResult& Hit : PieceHits)
+        {
+            Hit.Time = FMath::Lerp(Piece.StartTime, Piece.EndTime, Hit.Time);
+            Hit.Distance = Hit.Time * TotalLength;
+            OutHits.Add(Hit);
+        }
+        
+        // Like the engine's multi trace: stop at the first blocking hit
+        if (bBlocked)
+        {
+            return true;
+        }
     }
+    
+    return false;
 }
 
-void UToroidalWorldManager::CreateWrappedInstances(FWrappedObject& WrappedObject)
+bool UToroidalWorldManager::ToroidalSweepSingle(FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params) const
 {
-    if (!WrappedObject.OriginalActor.IsValid())
+    UWorld* World = GetWorld();
+    if (!World)
     {
-        return;
+        return false;
     }
     
-    AActor* OriginalActor = WrappedObject.OriginalActor.Get();
-    TArray<FVector> WrappedPositions = GetWrappedPositions(OriginalActor->GetActorLocation());
+    TArray<FToroidalQueryPiece> Pieces;
+    SplitQueryAtSeams(Start, End, Pieces);
     
-    // Clean up existing instances first
-    CleanupWrappedInstances(WrappedObject);
-    
-    // Create new instances
-    for (const FVector& Position : WrappedPositions)
+    const float TotalLength = FVector::Dist(Start, End);
+    const FVector ShapeExtent = Shape.GetExtent();
+    for (const FToroidalQueryPiece& Piece : Pieces)
     {
-        AActor* WrappedInstance = CreateWrappedInstance(OriginalActor, Position);
-        if (WrappedInstance)
+        // The shape may reach over an edge even though its center stays on the map
+        FBox SweptBounds(ForceInit);
+        SweptBounds += Piece.Start;
+        SweptBounds += Piece.End;
+        SweptBounds = SweptBounds.ExpandBy(ShapeExtent);
+        
+        TArray<FVector, TInlineAllocator<4>> Offsets;
+        GetSeamImageOffsets(SweptBounds, Offsets);
+        
+        bool bPieceHit = false;
+        for (const FVector& Offset : Offsets)
+        {
+            FHitResult Hit;
+            if (World->SweepSingleByChannel(Hit, Piece.Start + Offset, Piece.End + Offset, Rotation, TraceChannel, Shape, Params)
+                && (!bPieceHit || Hit.Time < OutHit.Time))
+            {
+                // Back into the frame of the piece
+                Hit.Location -= Offset;
+                Hit.ImpactPoint -= Offset;
+                Hit.TraceStart = Piece.Start;
+                Hit.TraceEnd = Piece.End;
+                OutHit = Hit;
+                bPieceHit = true;
+            }
+        }
+        
+        if (bPieceHit)
         {
-            WrappedObject.WrappedInstances.Add(WrappedInstance);
+            OutHit.Time = FMath::Lerp(Piece.StartTime, Piece.EndTime, OutHit.Time);
+            OutHit.Distance = OutHit.Time * TotalLength;
+            return true;
         }
     }
+    
+    return false;
 }
 
-void UToroidalWorldManager::UpdateWrappedInstances(FWrappedObject& WrappedObject)
+bool UToroidalWorldManager::ToroidalOverlapMulti(TArray<FOverlapResult>& OutOverlaps, const FVector& Position, const FQuat& Rotation, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params) const
 {
-    if (!WrappedObject.OriginalActor.IsValid())
+    OutOverlaps.Reset();
+    
+    UWorld* World = GetWorld();
+    if (!World)
     {
-        return;
+        return false;
     }
     
-    AActor* OriginalActor = WrappedObject.OriginalActor.Get();
+    const FVector CanonicalPosition = ToroidalToWorld(NormalizeToroidalCoordinate(WorldToToroidal(Position)));
+    const FVector ShapeExtent = Shape.GetExtent();
     
-    // Update canonical position
-    WrappedObject.CanonicalPosition = NormalizeToroidalCoordinate(WorldToToroidal(OriginalActor->GetActorLocation()));
+    TArray<FVector, TInlineAllocator<4>> Offsets;
+    GetSeamImageOffsets(FBox(CanonicalPosition - ShapeExtent, CanonicalPosition + ShapeExtent), Offsets);
     
-    // Wrap the original actor if it's gone outside bounds
-    FVector NormalizedWorldPos = ToroidalToWorld(WrappedObject.CanonicalPosition);
-    if (FVector::Dist(OriginalActor->GetActorLocation(), NormalizedWorldPos) > 0.1f)
+    bool bBlocked = false;
+    TArray<FOverlapResult> ImageOverlaps;
+    for (const FVector& Offset : Offsets)
     {
-        OriginalActor->SetActorLocation(NormalizedWorldPos);
+        bBlocked |= World->OverlapMultiByChannel(ImageOverlaps, CanonicalPosition + Offset, Rotation, TraceChannel, Shape, Params);
+        
+        // A component spanning the seam is found from both sides
+        for (const FOverlapResult& Overlap : ImageOverlaps)
+        {
+            const bool bAlreadyFound = OutOverlaps.ContainsByPredicate([&Overlap](const FOverlapResult& Existing) {
+                return Existing.Component == Overlap.Component && Existing.ItemIndex == Overlap.ItemIndex;
+            });
+            if (!bAlreadyFound)
+            {
+                OutOverlaps.Add(Overlap);
+            }
+        }
     }
     
-    // Check if we need to create/update wrapped instances
-    if (IsActorNearEdge(OriginalActor))
-    {
-        CreateWrappedInstances(WrappedObject);
-    }
-    else
+    return bBlocked;
+}
+
+TArray<AActor*> UToroidalWorldManager::GetActorsInRadius(const FVector& Center, float Radius) const
+{
+    TArray<AActor*> Result;
+    if (Radius < 0.0f)
     {
-        // Clean up wrapped instances if not near edge
-        CleanupWrappedInstances(WrappedObject);
+        return Result;
     }
     
-    // Update existing wrapped instances
-    TArray<FVector> WrappedPositions = GetWrappedPositions(OriginalActor->GetActorLocation());
+    FToroidalCoordinate CenterPos = NormalizeToroidalCoordinate(WorldToToroidal(Center));
     
-    // Remove invalid instances
-    WrappedObject.WrappedInstances.RemoveAll([](const TWeakObjectPtr<AActor>& Instance) {
-        return !Instance.IsValid();
-    });
+    TArray<FToroidalGridEntry> Candidates;
+    SpatialGrid.GatherCandidates(CenterPos, Radius, Radius, Candidates);
     
-    // Update positions of valid instances
-    for (int32 i = 0; i < WrappedObject.WrappedInstances.Num() && i < WrappedPositions.Num(); ++i)
+    for (const FToroidalGridEntry& Entry : Candidates)
     {
-        if (WrappedObject.WrappedInstances[i].IsValid())
+        if (GetToroidalDistance(Center, ToroidalToWorld(FToroidalCoordinate(Entry.Position))) <= Radius)
         {
-            WrappedObject.WrappedInstances[i]->SetActorLocation(WrappedPositions[i]);
-            WrappedObject.WrappedInstances[i]->SetActorRotation(OriginalActor->GetActorRotation());
+            Result.Add(Entry.Actor.Get());
         }
     }
+    
+    return Result;
 }
 
-void UToroidalWorldManager::CleanupWrappedInstances(FWrappedObject& WrappedObject)
+TArray<AActor*> UToroidalWorldManager::GetActorsInBox(const FVector& Center, const FVector2D& HalfExtents) const
 {
-    for (TWeakObjectPtr<AActor>& Instance : WrappedObject.WrappedInstances)
+    TArray<AActor*> Result;
+    if (HalfExtents.X < 0.0f || HalfExtents.Y < 0.0f)
     {
-        if (Instance.IsValid())
-        {
-            Instance->Destroy();
-        }
+        return Result;
+    }
+    
+    FToroidalCoordinate CenterPos = NormalizeToroidalCoordinate(WorldToToroidal(Center));
+    
+    TArray<FToroidalGridEntry> Candidates;
+    SpatialGrid.GatherCandidates(CenterPos, HalfExtents.X, HalfExtents.Y, Candidates);
+    
+    for (const FToroidalGridEntry& Entry : Candidates)
+    {
+        FVector Delta = GetToroidalDelta(Center, ToroidalToWorld(FToroidalCoordinate(Entry.Position)));
+        if (FMath::Abs(Delta.X) <= HalfExtents.X && FMath::Abs(Delta.Y) <= HalfExtents.Y)
+        {
+            Result.Add(Entry.Actor.Get());
+        }
+    }
+    
+    return Result;
+}
+
+TArray<AActor*> UToroidalWorldManager::GetKNearestActors(const FVector& Center, int32 K, float MaxRadius) const
+{
+    TArray<AActor*> Result;
+    if (K <= 0 || SpatialGrid.Num() == 0)
+    {
+        return Result;
+    }
+    
+    // Largest possible toroidal distance in the plane
+    const float WorldRadius = FMath::Sqrt(FMath::Square(WorldWidth * 0.5f) + FMath::Square(WorldHeight * 0.5f));
+    const float SearchLimit = MaxRadius > 0.0f ? FMath::Min(MaxRadius, WorldRadius) : WorldRadius;
+    
+    FToroidalCoordinate CenterPos = NormalizeToroidalCoordinate(WorldToToroidal(Center));
+    
+    TArray<TPair<float, AActor*>> Found;
+    float SearchRadius = FMath::Min(FMath::Max(SpatialGrid.GetCellSizeX(), SpatialGrid.GetCellSizeY()), SearchLimit);
+    
+    // Grow the search ring until K hits lie inside it (or we ran out of world)
+    while (true)
+    {
+        Found.Reset();
+        
+        TArray<FToroidalGridEntry> Candidates;
+        SpatialGrid.GatherCandidates(CenterPos, SearchRadius, SearchRadius, Candidates);
+        
+        for (const FToroidalGridEntry& Entry : Candidates)
+        {
+            float Distance = GetToroidalDistance(Center, ToroidalToWorld(FToroidalCoordinate(Entry.Position)));
+            if (Distance <= SearchRadius)
+            {
+                Found.Emplace(Distance, Entry.Actor.Get());
+            }
+        }
+        
+        if (Found.Num() >= K || SearchRadius >= SearchLimit)
+        {
+            break;
+        }
+        
+        SearchRadius = FMath::Min(SearchRadius * 2.0f, SearchLimit);
+    }
+    
+    Found.Sort([](const TPair<float, AActor*>& A, const TPair<float, AActor*>& B) {
+        return A.Key < B.Key;
+    });
+    
+    const int32 Count = FMath::Min(K, Found.Num());
+    Result.Reserve(Count);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        Result.Add(Found[i].Value);
+    }
+    
+    return Result;
+}
+
+bool UToroidalWorldManager::IsActorNearEdge(AActor* Actor) const
+{
+    if (!Actor)
+    {
+        return false;
+    }
+    
+    FToroidalCoordinate ToroidalPos = WorldToToroidal(Actor->GetActorLocation());
+    
+    float HalfWidth = WorldWidth * 0.5f;
+    float HalfHeight = WorldHeight * 0.5f;
+    
+    bool NearLeftRight = (FMath::Abs(ToroidalPos.X - HalfWidth) < WrapThreshold) || 
+                        (FMath::Abs(ToroidalPos.X + HalfWidth) < WrapThreshold);
+    bool NearTopBottom = (FMath::Abs(ToroidalPos.Y - HalfHeight) < WrapThreshold) || 
+                        (FMath::Abs(ToroidalPos.Y + HalfHeight) < WrapThreshold);
+    
+    return NearLeftRight || NearTopBottom;
+}
+
+TArray<FVector> UToroidalWorldManager::GetWrappedPositions(const FVector& OriginalPosition) const
+{
+    TArray<FVector> Positions;
+    ComputeWrappedPositions(NormalizeToroidalCoordinate(WorldToToroidal(OriginalPosition)), Positions);
+    return Positions;
+}
+
+void UToroidalWorldManager::ComputeWrappedPositions(const FToroidalCoordinate& NormalizedPosition, TArray<FVector>& OutPositions) const
+{
+    const FToroidalCoordinate& ToroidalPos = NormalizedPosition;
+    
+    float HalfWidth = WorldWidth * 0.5f;
+    float HalfHeight = WorldHeight * 0.5f;
+    
+    // Check if near edges and add wrapped positions
+    bool NearLeft = ToroidalPos.X < (-HalfWidth + WrapThreshold);
+    bool NearRight = ToroidalPos.X > (HalfWidth - WrapThreshold);
+    bool NearBottom = ToroidalPos.Y < (-HalfHeight + WrapThreshold);
+    bool NearTop = ToroidalPos.Y > (HalfHeight - WrapThreshold);
+    
+    // Right edge wrapping
+    if (NearRight)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.X -= WorldWidth;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    // Left edge wrapping
+    if (NearLeft)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.X += WorldWidth;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    // Top edge wrapping
+    if (NearTop)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.Y -= WorldHeight;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    // Bottom edge wrapping
+    if (NearBottom)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.Y += WorldHeight;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    // Corner wrapping
+    if (NearRight && NearTop)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.X -= WorldWidth;
+        WrappedPos.Y -= WorldHeight;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    if (NearRight && NearBottom)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.X -= WorldWidth;
+        WrappedPos.Y += WorldHeight;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    if (NearLeft && NearTop)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.X += WorldWidth;
+        WrappedPos.Y -= WorldHeight;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+    
+    if (NearLeft && NearBottom)
+    {
+        FToroidalCoordinate WrappedPos = ToroidalPos;
+        WrappedPos.X += WorldWidth;
+        WrappedPos.Y += WorldHeight;
+        OutPositions.Add(ToroidalToWorld(WrappedPos));
+    }
+}
+
+EToroidalEdgeFlags UToroidalWorldManager::GetEdgeFlags(const FToroidalCoordinate& NormalizedPosition) const
+{
+    float HalfWidth = WorldWidth * 0.5f;
+    float HalfHeight = WorldHeight * 0.5f;
+    
+    // Same thresholds as GetWrappedPositions
+    EToroidalEdgeFlags Flags = EToroidalEdgeFlags::None;
+    if (NormalizedPosition.X < (-HalfWidth + WrapThreshold))
+    {
+        Flags |= EToroidalEdgeFlags::Left;
+    }
+    if (NormalizedPosition.X > (HalfWidth - WrapThreshold))
+    {
+        Flags |= EToroidalEdgeFlags::Right;
+    }
+    if (NormalizedPosition.Y < (-HalfHeight + WrapThreshold))
+    {
+        Flags |= EToroidalEdgeFlags::Bottom;
+    }
+    if (NormalizedPosition.Y > (HalfHeight - WrapThreshold))
+    {
+        Flags |= EToroidalEdgeFlags::Top;
+    }
+    
+    return Flags;
+}
+
+bool UToroidalWorldManager::IsPositionInView(const FVector& WorldPosition) const
+{
+    if (!bCullGhostsToView || !ViewBounds.bIsValid)
+    {
+        return true;
+    }
+    
+    const FToroidalCoordinate Position = WorldToToroidal(WorldPosition);
+    return ViewBounds.IsInside(FVector2D(Position.X, Position.Y));
+}
+
+void UToroidalWorldManager::UpdateViewBounds()
+{
+    FBox2D NewBounds(ForceInit);
+    if (bCullGhostsToView)
+    {
+        ComputeViewBounds(NewBounds);
+    }
+    ViewBounds = NewBounds;
+    
+    // Small camera moves stay inside the margin; only re-evaluate once the
+    // view has moved a good part of it (or culling switched on or off)
+    const float Tolerance = ViewCullMargin * 0.25f;
+    const bool bViewChanged = ViewBounds.bIsValid != EvaluatedViewBounds.bIsValid
+        || (ViewBounds.bIsValid
+            && (!ViewBounds.Min.Equals(EvaluatedViewBounds.Min, Tolerance) || !ViewBounds.Max.Equals(EvaluatedViewBounds.Max, Tolerance)));
+    if (!bViewChanged)
+    {
+        // Keep judging against the view the ghosts were laid out for
+        ViewBounds = EvaluatedViewBounds;
+        return;
+    }
+    EvaluatedViewBounds = ViewBounds;
+    
+    // Only objects near an edge have images whose visibility can change
+    for (int32 Index = 0; Index < TrackedObjects.Num(); ++Index)
+    {
+        if (TrackedObjects.EdgeFlags[Index] != EToroidalEdgeFlags::None || TrackedObjects.Ghosts[Index].WrappedInstances.Num() > 0 || TrackedObjects.Ghosts[Index].ProxyInstances.Num() > 0)
+        {
+            MarkIndexDirty(Index);
+        }
+    }
+}
+
+bool UToroidalWorldManager::ComputeViewBounds(FBox2D& OutBounds) const
+{
+    UWorld* World = GetWorld();
+    APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+    if (!PlayerController || !PlayerController->IsLocalController() || !PlayerController->PlayerCameraManager)
+    {
+        return false;
+    }
+    
+    int32 ViewportX = 0;
+    int32 ViewportY = 0;
+    PlayerController->GetViewportSize(ViewportX, ViewportY);
+    if (ViewportX <= 0 || ViewportY <= 0)
+    {
+        return false;
+    }
+    
+    const APlayerCameraManager* CameraManager = PlayerController->PlayerCameraManager;
+    const FVector CameraLocation = CameraManager->GetCameraLocation();
+    const FRotationMatrix CameraAxes(CameraManager->GetCameraRotation());
+    const FVector Forward = CameraAxes.GetScaledAxis(EAxis::X);
+    const FVector Right = CameraAxes.GetScaledAxis(EAxis::Y);
+    const FVector Up = CameraAxes.GetScaledAxis(EAxis::Z);
+    
+    // FOV is horizontal; derive the vertical half angle from the aspect ratio
+    const float TanHalfHorizontal = FMath::Tan(FMath::DegreesToRadians(CameraManager->GetFOVAngle() * 0.5f));
+    const float TanHalfVertical = TanHalfHorizontal * ViewportY / ViewportX;
+    
+    // Intersect the four frustum corner rays with the ground plane
+    const float GroundZ = WorldCenter.Z;
+    FBox2D Footprint(ForceInit);
+    Footprint += FVector2D(CameraLocation.X, CameraLocation.Y);
+    for (int32 Corner = 0; Corner < 4; ++Corner)
+    {
+        const float SideX = (Corner & 1) ? 1.0f : -1.0f;
+        const float SideY = (Corner & 2) ? 1.0f : -1.0f;
+        const FVector Ray = (Forward + Right * TanHalfHorizontal * SideX + Up * TanHalfVertical * SideY).GetSafeNormal();
+        
+        float Distance = MaxViewDistance;
+        if (Ray.Z < -KINDA_SMALL_NUMBER)
+        {
+            Distance = FMath::Min((GroundZ - CameraLocation.Z) / Ray.Z, MaxViewDistance);
+        }
+        
+        const FVector Hit = CameraLocation + Ray * FMath::Max(Distance, 0.0f);
+        Footprint += FVector2D(Hit.X, Hit.Y);
+    }
+    
+    // Into toroidal space, but not wrapped: the camera isn't kept on the
+    // canonical map, and images are tested at the spot they'd be drawn
+    Footprint = Footprint.ExpandBy(ViewCullMargin);
+    Footprint = Footprint.ShiftBy(-FVector2D(WorldCenter.X, WorldCenter.Y));
+    
+    OutBounds = Footprint;
+    return true;
+}
+
+void UToroidalWorldManager::SetWorldDimensions(float Width, float Height)
+{
+    WorldWidth = Width;
+    WorldHeight = Height;
+    
+    // Cell layout and fixed point scale depend on the world size
+    RebuildSpatialGrid();
+    RebuildFixedSpace();
+    
+    // Update all existing objects
+    TGuardValue<bool> ApplyingWrapGuard(bApplyingWrap, true);
+    for (int32 Index = 0; Index < TrackedObjects.Num(); ++Index)
+    {
+        UpdateWrappedInstances(Index);
+    }
+}
+
+void UToroidalWorldManager::RebuildFixedSpace()
+{
+    if (!FixedSpace.Initialize(WorldWidth, WorldHeight) && bUseFixedPointCoordinates)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ToroidalWorldManager: fixed point coordinates need power-of-two world dimensions, got %fx%f. Fixed point space is disabled."),
+               WorldWidth, WorldHeight);
+    }
+}
+
+FToroidalFixedCoordinate UToroidalWorldManager::WorldToFixed(const FVector& WorldPosition) const
+{
+    return FixedSpace.FromToroidal(WorldPosition - WorldCenter);
+}
+
+FVector UToroidalWorldManager::FixedToWorld(const FToroidalFixedCoordinate& Coordinate) const
+{
+    return FixedSpace.ToToroidal(Coordinate) + WorldCenter;
+}
+
+void UToroidalWorldManager::RebuildSpatialGrid()
+{
+    SpatialGrid.Initialize(WorldWidth, WorldHeight, SpatialCellSize);
+    
+    for (int32 Index = 0; Index < TrackedObjects.Num(); ++Index)
+    {
+        if (AActor* Actor = TrackedObjects.Actors[Index].Get())
+        {
+            const FToroidalCoordinate Position(TrackedObjects.PositionX[Index], TrackedObjects.PositionY[Index], TrackedObjects.PositionZ[Index]);
+            SpatialGrid.AddOrUpdate(Actor, NormalizeToroidalCoordinate(Position));
+        }
+    }
+}
+
+void UToroidalWorldManager::CreateWrappedInstances(int32 Index)
+{
+    AActor* OriginalActor = TrackedObjects.Actors[Index].Get();
+    if (!OriginalActor)
+    {
+        return;
+    }
+    
+    TrackedObjects.EdgeFlags[Index] = GetEdgeFlags(NormalizeToroidalCoordinate(WorldToToroidal(OriginalActor->GetActorLocation())));
+    SyncWrappedInstances(Index, GetWrappedPositions(OriginalActor->GetActorLocation()));
+}
+
+void UToroidalWorldManager::UpdateWrappedInstances(int32 Index)
+{
+    AActor* OriginalActor = TrackedObjects.Actors[Index].Get();
+    if (!OriginalActor)
+    {
+        return;
+    }
+    
+    // Update canonical position
+    FToroidalWrapCommand Command;
+    Command.Index = Index;
+    Command.Handle = TrackedObjects.GetHandle(Index);
+    Command.CurrentLocation = OriginalActor->GetActorLocation();
+    
+    const FToroidalCoordinate CanonicalPosition = NormalizeToroidalCoordinate(WorldToToroidal(Command.CurrentLocation));
+    TrackedObjects.PositionX[Index] = CanonicalPosition.X;
+    TrackedObjects.PositionY[Index] = CanonicalPosition.Y;
+    TrackedObjects.PositionZ[Index] = CanonicalPosition.Z;
+    
+    BuildWrapCommand(CanonicalPosition, Command);
+    ApplyWrapCommand(Command);
+}
+
+void UToroidalWorldManager::BuildWrapCommand(const FToroidalCoordinate& CanonicalPosition, FToroidalWrapCommand& Command) const
+{
+    Command.CanonicalPosition = CanonicalPosition;
+    Command.NormalizedWorldPosition = ToroidalToWorld(CanonicalPosition);
+    
+    // Wrap the original actor if it's gone outside bounds
+    Command.bRelocate = FVector::Dist(Command.CurrentLocation, Command.NormalizedWorldPosition) > 0.1f;
+    
+    Command.EdgeFlags = GetEdgeFlags(CanonicalPosition);
+    Command.WrappedPositions.Reset();
+    ComputeWrappedPositions(CanonicalPosition, Command.WrappedPositions);
+    
+    // Images nobody can see stay logical-only
+    if (bCullGhostsToView && ViewBounds.bIsValid)
+    {
+        Command.WrappedPositions.RemoveAll([this](const FVector& Position) {
+            return !IsPositionInView(Position);
+        });
+    }
+}
+
+void UToroidalWorldManager::ApplyWrapCommand(const FToroidalWrapCommand& Command)
+{
+    int32 Index = TrackedObjects.GetDenseIndex(Command.Handle);
+    AActor* OriginalActor = Index != INDEX_NONE ? TrackedObjects.Actors[Index].Get() : nullptr;
+    if (!OriginalActor)
+    {
+        return;
+    }
+    
+    SpatialGrid.AddOrUpdate(OriginalActor, Command.CanonicalPosition);
+    
+    if (Command.bRelocate)
+    {
+        OriginalActor->SetActorLocation(Command.NormalizedWorldPosition);
+        
+        // The move may have destroyed this or another tracked actor
+        Index = TrackedObjects.GetDenseIndex(Command.Handle);
+        if (Index == INDEX_NONE)
+        {
+            return;
+        }
+    }
+    
+    // Same edge set keeps the same ghosts in the same order - they only move.
+    // A changed edge set reuses what it can and takes the rest from the pool.
+    TrackedObjects.EdgeFlags[Index] = Command.EdgeFlags;
+    SyncWrappedInstances(Index, Command.WrappedPositions);
+}
+
+void UToroidalWorldManager::SyncWrappedInstances(int32 Index, const TArray<FVector>& WrappedPositions)
+{
+    AActor* OriginalActor = TrackedObjects.Actors[Index].Get();
+    if (!OriginalActor)
+    {
+        return;
+    }
+    
+    // Proxies need an actor to host their components
+    if (GhostMode == EToroidalGhostMode::MeshProxy && GetOwner())
+    {
+        SyncProxyInstances(Index, WrappedPositions);
+        return;
+    }
+    
+    TArray<TWeakObjectPtr<AActor>>& WrappedInstances = TrackedObjects.Ghosts[Index].WrappedInstances;
+    
+    // Remove instances destroyed behind our back
+    WrappedInstances.RemoveAll([](const TWeakObjectPtr<AActor>& Instance) {
+        return !Instance.IsValid();
+    });
+    
+    // Return surplus ghosts to the pool
+    while (WrappedInstances.Num() > WrappedPositions.Num())
+    {
+        ReleaseGhost(WrappedInstances.Pop(EAllowShrinking::No).Get());
+    }
+    
+    // Fill up missing ones
+    while (WrappedInstances.Num() < WrappedPositions.Num())
+    {
+        AActor* Ghost = AcquireGhost(OriginalActor, WrappedPositions[WrappedInstances.Num()]);
+        if (!Ghost)
+        {
+            break;
+        }
+        WrappedInstances.Add(Ghost);
+    }
+    
+    // Move everything into place
+    const FRotator OriginalRotation = OriginalActor->GetActorRotation();
+    for (int32 i = 0; i < WrappedInstances.Num(); ++i)
+    {
+        WrappedInstances[i]->SetActorLocationAndRotation(WrappedPositions[i], OriginalRotation);
+    }
+}
+
+void UToroidalWorldManager::CleanupWrappedInstances(int32 Index)
+{
+    FToroidalGhostSet& Ghosts = TrackedObjects.Ghosts[Index];
+    
+    for (TWeakObjectPtr<AActor>& Instance : Ghosts.WrappedInstances)
+    {
+        ReleaseGhost(Instance.Get());
+    }
+    Ghosts.WrappedInstances.Empty();
+    
+    for (FToroidalGhostProxy& Proxy : Ghosts.ProxyInstances)
+    {
+        ReleaseProxy(Proxy);
+    }
+    Ghosts.ProxyInstances.Empty();
+    TrackedObjects.EdgeFlags[Index] = EToroidalEdgeFlags::None;
+}
+
+void UToroidalWorldManager::SyncProxyInstances(int32 Index, const TArray<FVector>& WrappedPositions)
+{
+    AActor* OriginalActor = TrackedObjects.Actors[Index].Get();
+    TArray<FToroidalGhostProxy>& ProxyInstances = TrackedObjects.Ghosts[Index].ProxyInstances;
+    
+    while (ProxyInstances.Num() > WrappedPositions.Num())
+    {
+        FToroidalGhostProxy Proxy = ProxyInstances.Pop(EAllowShrinking::No);
+        ReleaseProxy(Proxy);
+    }
+    
+    while (ProxyInstances.Num() < WrappedPositions.Num())
+    {
+        ProxyInstances.Add(AcquireProxy(OriginalActor));
+    }
+    
+    // Each image is the original shifted by a whole world size
+    const FVector OriginalLocation = OriginalActor->GetActorLocation();
+    for (int32 i = 0; i < ProxyInstances.Num(); ++i)
+    {
+        UpdateProxy(ProxyInstances[i], WrappedPositions[i] - OriginalLocation);
+    }
+}
+
+FToroidalGhostProxy UToroidalWorldManager::AcquireProxy(AActor* OriginalActor)
+{
+    FToroidalGhostProxy Proxy;
+    Stats.ProxiesAcquired++;
+    
+    TInlineComponentArray<UMeshComponent*> Meshes(OriginalActor);
+    for (UMeshComponent* Mesh : Meshes)
+    {
+        // Never mirror our own proxies
+        if (Mesh->IsA<UInstancedStaticMeshComponent>())
+        {
+            continue;
+        }
+        
+        FToroidalProxyElement Element;
+        Element.SourceComponent = Mesh;
+        
+        // Keep the element even if it can't be drawn yet (mesh still
+        // loading); UpdateProxy retries the next time the object is dirty
+        if (UStaticMeshComponent* StaticSource = Cast<UStaticMeshComponent>(Mesh))
+        {
+            AcquireProxyInstance(StaticSource, Element);
+        }
+        else if (USkeletalMeshComponent* SkeletalSource = Cast<USkeletalMeshComponent>(Mesh))
+        {
+            AcquireSkeletalProxyFor(SkeletalSource, Element);
+        }
+        else
+        {
+            continue;
+        }
+        
+        Proxy.Elements.Add(Element);
+    }
+    
+    return Proxy;
+}
+
+void UToroidalWorldManager::ReleaseProxy(FToroidalGhostProxy& Proxy)
+{
+    for (FToroidalProxyElement& Element : Proxy.Elements)
+    {
+        if (Element.Mesh)
+        {
+            ReleaseProxyInstance(Element);
+        }
+        else if (USkeletalMeshComponent* SkeletalProxy = Element.SkeletalProxy.Get())
+        {
+            SkeletalProxy->SetLeaderPoseComponent(nullptr);
+            SkeletalProxy->SetVisibility(false);
+            FreeSkeletalProxies.Add(SkeletalProxy);
+        }
+    }
+    Proxy.Elements.Empty();
+}
+
+void UToroidalWorldManager::UpdateProxy(FToroidalGhostProxy& Proxy, const FVector& Offset)
+{
+    for (FToroidalProxyElement& Element : Proxy.Elements)
+    {
+        UMeshComponent* Source = Element.SourceComponent.Get();
+        if (!Source)
+        {
+            continue;
+        }
+        
+        FTransform ImageTransform = Source->GetComponentTransform();
+        ImageTransform.AddToTranslation(Offset);
+        const bool bVisible = Source->IsVisible() && !Source->GetOwner()->IsHidden();
+        
+        if (UStaticMeshComponent* StaticSource = Cast<UStaticMeshComponent>(Source))
+        {
+            // Meshes on units and buildings load asynchronously; follow the swap.
+            // Without a mesh the slot stays empty until the load marks us dirty.
+            if (StaticSource->GetStaticMesh() != Element.Mesh)
+            {
+                if (Element.Mesh)
+                {
+                    ReleaseProxyInstance(Element);
+                }
+                if (!AcquireProxyInstance(StaticSource, Element))
+                {
+                    continue;
+                }
+            }
+            
+            if (!bVisible)
+            {
+                ImageTransform.SetScale3D(FVector::ZeroVector);
+            }
+            
+            if (FToroidalProxyBatch* Batch = ProxyBatches.Find(Element.Mesh))
+            {
+                Batch->Component->UpdateInstanceTransform(Element.InstanceIndex, ImageTransform, true, true, true);
+            }
+        }
+        else if (USkeletalMeshComponent* SkeletalSource = Cast<USkeletalMeshComponent>(Source))
+        {
+            if (!Element.SkeletalProxy.IsValid() && !AcquireSkeletalProxyFor(SkeletalSource, Element))
+            {
+                continue;
+            }
+            
+            USkeletalMeshComponent* SkeletalProxy = Element.SkeletalProxy.Get();
+            if (SkeletalProxy->GetSkeletalMeshAsset() != SkeletalSource->GetSkeletalMeshAsset())
+            {
+                SkeletalProxy->SetSkeletalMesh(SkeletalSource->GetSkeletalMeshAsset());
+            }
+            
+            SkeletalProxy->SetWorldTransform(ImageTransform, false, nullptr, ETeleportType::TeleportPhysics);
+            SkeletalProxy->SetVisibility(bVisible);
+        }
+    }
+}
+
+bool UToroidalWorldManager::AcquireProxyInstance(UStaticMeshComponent* Source, FToroidalProxyElement& Element)
+{
+    UStaticMesh* Mesh = Source->GetStaticMesh();
+    if (!Mesh)
+    {
+        return false;
+    }
+    
+    FToroidalProxyBatch& Batch = ProxyBatches.FindOrAdd(Mesh);
+    if (!Batch.Component)
+    {
+        // One instanced component per mesh; materials come from the first source seen
+        UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+        Component->SetMobility(EComponentMobility::Movable);
+        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        Component->SetCanEverAffectNavigation(false);
+        Component->SetStaticMesh(Mesh);
+        for (int32 MaterialIndex = 0; MaterialIndex < Source->GetNumMaterials(); ++MaterialIndex)
+        {
+            Component->SetMaterial(MaterialIndex, Source->GetMaterial(MaterialIndex));
+        }
+        Component->RegisterComponent();
+        GetOwner()->AddInstanceComponent(Component);
+        
+        Batch.Component = Component;
+    }
+    
+    Element.Mesh = Mesh;
+    if (Batch.FreeInstances.Num() > 0)
+    {
+        Element.InstanceIndex = Batch.FreeInstances.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Element.InstanceIndex = Batch.Component->AddInstance(FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), true);
+    }
+    
+    return true;
+}
+
+bool UToroidalWorldManager::AcquireSkeletalProxyFor(USkeletalMeshComponent* Source, FToroidalProxyElement& Element)
+{
+    USkeletalMeshComponent* SkeletalProxy = AcquireSkeletalProxy();
+    if (!SkeletalProxy)
+    {
+        return false;
+    }
+    
+    // Follow the original's pose - no animation evaluation of our own
+    SkeletalProxy->SetSkeletalMesh(Source->GetSkeletalMeshAsset());
+    SkeletalProxy->SetLeaderPoseComponent(Source);
+    Element.SkeletalProxy = SkeletalProxy;
+    return true;
+}
+
+void UToroidalWorldManager::ReleaseProxyInstance(FToroidalProxyElement& Element)
+{
+    // Instances are never removed (that would shift indices), only hidden and reused
+    if (FToroidalProxyBatch* Batch = ProxyBatches.Find(Element.Mesh))
+    {
+        Batch->Component->UpdateInstanceTransform(Element.InstanceIndex, FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), true, true, true);
+        Batch->FreeInstances.Add(Element.InstanceIndex);
+    }
+    
+    Element.Mesh = nullptr;
+    Element.InstanceIndex = INDEX_NONE;
+}
+
+USkeletalMeshComponent* UToroidalWorldManager::AcquireSkeletalProxy()
+{
+    while (FreeSkeletalProxies.Num() > 0)
+    {
+        USkeletalMeshComponent* SkeletalProxy = FreeSkeletalProxies.Pop(EAllowShrinking::No);
+        if (IsValid(SkeletalProxy))
+        {
+            return SkeletalProxy;
+        }
+    }
+    
+    if (!GetOwner())
+    {
+        return nullptr;
+    }
+    
+    USkeletalMeshComponent* SkeletalProxy = NewObject<USkeletalMeshComponent>(GetOwner());
+    SkeletalProxy->SetMobility(EComponentMobility::Movable);
+    SkeletalProxy->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SkeletalProxy->SetCanEverAffectNavigation(false);
+    SkeletalProxy->SetGenerateOverlapEvents(false);
+    SkeletalProxy->RegisterComponent();
+    
+    // The leader refreshes followers, so the proxy itself never has to tick
+    SkeletalProxy->SetComponentTickEnabled(false);
+    GetOwner()->AddInstanceComponent(SkeletalProxy);
+    
+    return SkeletalProxy;
+}
+
+AActor* UToroidalWorldManager::AcquireGhost(AActor* OriginalActor, const FVector& Position)
+{
+    if (!OriginalActor)
+    {
+        return nullptr;
+    }
+    
+    if (FToroidalGhostPool* Pool = GhostPools.Find(OriginalActor->GetClass()))
+    {
+        while (Pool->FreeGhosts.Num() > 0)
+        {
+            AActor* Ghost = Pool->FreeGhosts.Pop(EAllowShrinking::No).Get();
+            if (!Ghost)
+            {
+                continue;
+            }
+            
+            // Pooled ghosts may have been copied from another actor of the same class
+            CopyGhostAppearance(OriginalActor, Ghost);
+            Ghost->SetActorLocationAndRotation(Position, OriginalActor->GetActorRotation());
+            Ghost->SetActorHiddenInGame(false);
+            Ghost->SetActorTickEnabled(OriginalActor->IsActorTickEnabled());
+            
+            Stats.GhostsReused++;
+            UE_LOG(LogTemp, VeryVerbose, TEXT("Reused pooled wrapped instance for %s"), *OriginalActor->GetName());
+            return Ghost;
+        }
+    }
+    
+    return CreateWrappedInstance(OriginalActor, Position);
+}
+
+void UToroidalWorldManager::ReleaseGhost(AActor* Ghost)
+{
+    if (!Ghost)
+    {
+        return;
+    }
+    
+    FToroidalGhostPool& Pool = GhostPools.FindOrAdd(Ghost->GetClass());
+    if (Pool.FreeGhosts.Num() >= MaxPooledGhostsPerClass)
+    {
+        Stats.GhostsDestroyed++;
+        Ghost->Destroy();
+        return;
+    }
+    
+    // Park the ghost: invisible and inert until it is needed again
+    Ghost->SetActorHiddenInGame(true);
+    Ghost->SetActorTickEnabled(false);
+    Pool.FreeGhosts.Add(Ghost);
+}
+
+void UToroidalWorldManager::CopyGhostAppearance(AActor* OriginalActor, AActor* Ghost) const
+{
+    TInlineComponentArray<UMeshComponent*> OriginalMeshes(OriginalActor);
+    TInlineComponentArray<UMeshComponent*> GhostMeshes(Ghost);
+    
+    // Components come from the same class, so match them by name
+    for (UMeshComponent* GhostMesh : GhostMeshes)
+    {
+        UMeshComponent* const* Source = OriginalMeshes.FindByPredicate([GhostMesh](const UMeshComponent* Mesh) {
+            return Mesh->GetFName() == GhostMesh->GetFName();
+        });
+        if (!Source)
+        {
+            continue;
+        }
+        
+        if (UStaticMeshComponent* GhostStatic = Cast<UStaticMeshComponent>(GhostMesh))
+        {
+            if (UStaticMeshComponent* SourceStatic = Cast<UStaticMeshComponent>(*Source))
+            {
+                GhostStatic->SetStaticMesh(SourceStatic->GetStaticMesh());
+            }
+        }
+        else if (USkeletalMeshComponent* GhostSkeletal = Cast<USkeletalMeshComponent>(GhostMesh))
+        {
+            if (USkeletalMeshComponent* SourceSkeletal = Cast<USkeletalMeshComponent>(*Source))
+            {
+                GhostSkeletal->SetSkeletalMesh(SourceSkeletal->GetSkeletalMeshAsset());
+            }
+        }
     }
-    WrappedObject.WrappedInstances.Empty();
 }
 
 bool UToroidalWorldManager::ShouldExcludeActor(AActor* Actor) const
@@ -465,6 +1582,8 @@ AActor* UToroidalWorldManager::CreateWrappedInstance(AActor* OriginalActor, cons
     
     if (WrappedInstance)
     {
+        Stats.GhostsSpawned++;
+        
         // Mark as a wrapped instance (you might want to add a component or tag)
         WrappedInstance->Tags.Add(TEXT("WrappedInstance"));
         
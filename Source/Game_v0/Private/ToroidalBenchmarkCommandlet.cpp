@@ -0,0 +1,208 @@
+#include "ToroidalBenchmarkCommandlet.h"
+#include "Toroid.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+#include "Algo/Accumulate.h"
+
+namespace
+{
+    struct FBenchmarkFrame
+    {
+        double WrapTickMs = 0.0;
+        FToroidalWorldStats Stats;
+        double UsedPhysicalMB = 0.0;
+    };
+
+    double GetPercentile(TArray<double> Values, float Percentile)
+    {
+        if (Values.Num() == 0)
+        {
+            return 0.0;
+        }
+
+        Values.Sort();
+        const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+        return Values[Index];
+    }
+
+    FVector GetRandomHeading(FRandomStream& Random)
+    {
+        const float Angle = Random.FRandRange(0.0f, 2.0f * PI);
+        return FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+    }
+
+    double GetUsedPhysicalMB()
+    {
+        return FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+    }
+}
+
+UToroidalBenchmarkCommandlet::UToroidalBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UToroidalBenchmarkCommandlet::Main(const FString& Params)
+{
+    int32 NumActors = 2000;
+    int32 NumFrames = 600;
+    int32 Seed = 1;
+    float Speed = 600.0f;
+    float MaxP99Ms = 0.0f;
+    FString GhostModeName = TEXT("MeshProxy");
+    FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), TEXT("Toroid.csv"));
+
+    FParse::Value(*Params, TEXT("Actors="), NumActors);
+    FParse::Value(*Params, TEXT("Frames="), NumFrames);
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    FParse::Value(*Params, TEXT("Speed="), Speed);
+    FParse::Value(*Params, TEXT("MaxP99Ms="), MaxP99Ms);
+    FParse::Value(*Params, TEXT("GhostMode="), GhostModeName);
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    NumActors = FMath::Max(NumActors, 1);
+    NumFrames = FMath::Max(NumFrames, 1);
+
+    // Throwaway game world, no level loaded
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ToroidalBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    World->BeginPlay();
+
+    AActor* Host = World->SpawnActor<AActor>();
+    Host->SetRootComponent(NewObject<USceneComponent>(Host, TEXT("Root")));
+    Host->GetRootComponent()->RegisterComponent();
+
+    UToroidalWorldManager* Manager = NewObject<UToroidalWorldManager>(Host);
+    Manager->GhostMode = GhostModeName.Equals(TEXT("ActorCopy"), ESearchCase::IgnoreCase) ? EToroidalGhostMode::ActorCopy : EToroidalGhostMode::MeshProxy;
+    Manager->bCullGhostsToView = false;
+    Manager->SetComponentTickEnabled(false); // Driven manually below
+    Manager->RegisterComponent(); // Host has begun play, so this begins play too
+
+    // A real mesh so proxies and ghosts carry their usual cost
+    UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+    FRandomStream Random(Seed);
+    const float HalfWidth = Manager->WorldWidth * 0.5f;
+    const float HalfHeight = Manager->WorldHeight * 0.5f;
+
+    TArray<AActor*> Actors;
+    TArray<FVector> Headings;
+    Actors.Reserve(NumActors);
+    Headings.Reserve(NumActors);
+    for (int32 i = 0; i < NumActors; ++i)
+    {
+        const FVector Location = Manager->WorldCenter + FVector(Random.FRandRange(-HalfWidth, HalfWidth), Random.FRandRange(-HalfHeight, HalfHeight), 0.0f);
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParams);
+        if (!Actor)
+        {
+            continue;
+        }
+
+        Actor->SetMobility(EComponentMobility::Movable);
+        Actor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+        Actor->SetActorEnableCollision(false);
+        Manager->RegisterActor(Actor);
+
+        Actors.Add(Actor);
+        Headings.Add(GetRandomHeading(Random));
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("ToroidalBenchmark: %d actors, %d frames, ghost mode %s"), Actors.Num(), NumFrames, *GhostModeName);
+
+    const float DeltaTime = 1.0f / 60.0f;
+    TArray<FBenchmarkFrame> Frames;
+    Frames.Reserve(NumFrames);
+
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        // Random walk: mostly keep heading, occasionally turn. Crossing a seam
+        // is left to the manager, which is what we want to measure.
+        for (int32 i = 0; i < Actors.Num(); ++i)
+        {
+            if (Random.FRand() < 0.02f)
+            {
+                Headings[i] = GetRandomHeading(Random);
+            }
+            Actors[i]->SetActorLocation(Actors[i]->GetActorLocation() + Headings[i] * Speed * DeltaTime);
+        }
+
+        Manager->ResetStats();
+
+        const double StartTime = FPlatformTime::Seconds();
+        Manager->ProcessDirtyObjects();
+        const double EndTime = FPlatformTime::Seconds();
+
+        FBenchmarkFrame& Result = Frames.AddDefaulted_GetRef();
+        Result.WrapTickMs = (EndTime - StartTime) * 1000.0;
+        Result.Stats = Manager->GetStats();
+        Result.UsedPhysicalMB = GetUsedPhysicalMB();
+    }
+
+    // Per-frame rows, summary appended as Metric,Value rows after a blank line
+    TArray<double> TickTimes;
+    int64 TotalSpawned = 0;
+    int64 TotalProxies = 0;
+    FString Csv = TEXT("Frame,WrapTickMs,ObjectsEvaluated,GhostsSpawned,GhostsReused,GhostsDestroyed,ProxiesAcquired,UsedPhysicalMB\n");
+    for (int32 Frame = 0; Frame < Frames.Num(); ++Frame)
+    {
+        const FBenchmarkFrame& Result = Frames[Frame];
+        Csv += FString::Printf(TEXT("%d,%.4f,%d,%d,%d,%d,%d,%.1f\n"), Frame, Result.WrapTickMs,
+                               Result.Stats.ObjectsEvaluated, Result.Stats.GhostsSpawned, Result.Stats.GhostsReused,
+                               Result.Stats.GhostsDestroyed, Result.Stats.ProxiesAcquired, Result.UsedPhysicalMB);
+
+        TickTimes.Add(Result.WrapTickMs);
+        TotalSpawned += Result.Stats.GhostsSpawned;
+        TotalProxies += Result.Stats.ProxiesAcquired;
+    }
+
+    const double P50 = GetPercentile(TickTimes, 0.5f);
+    const double P99 = GetPercentile(TickTimes, 0.99f);
+    const double Mean = TickTimes.Num() > 0 ? Algo::Accumulate(TickTimes, 0.0) / TickTimes.Num() : 0.0;
+    const double FinalMB = Frames.Num() > 0 ? Frames.Last().UsedPhysicalMB : 0.0;
+
+    Csv += TEXT("\nMetric,Value\n");
+    Csv += FString::Printf(TEXT("Actors,%d\n"), Actors.Num());
+    Csv += FString::Printf(TEXT("Frames,%d\n"), Frames.Num());
+    Csv += FString::Printf(TEXT("WrapTickMeanMs,%.4f\n"), Mean);
+    Csv += FString::Printf(TEXT("WrapTickP50Ms,%.4f\n"), P50);
+    Csv += FString::Printf(TEXT("WrapTickP99Ms,%.4f\n"), P99);
+    Csv += FString::Printf(TEXT("GhostsSpawned,%lld\n"), TotalSpawned);
+    Csv += FString::Printf(TEXT("ProxiesAcquired,%lld\n"), TotalProxies);
+    Csv += FString::Printf(TEXT("FinalUsedPhysicalMB,%.1f\n"), FinalMB);
+
+    if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ToroidalBenchmark: Failed to write %s"), *OutputPath);
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("ToroidalBenchmark: p50 %.3f ms, p99 %.3f ms, mean %.3f ms, %lld ghosts spawned -> %s"),
+           P50, P99, Mean, TotalSpawned, *OutputPath);
+
+    // Tear down
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    if (MaxP99Ms > 0.0f && P99 > MaxP99Ms)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ToroidalBenchmark: p99 %.3f ms exceeds budget of %.3f ms"), P99, MaxP99Ms);
+        return 1;
+    }
+
+    return 0;
+}
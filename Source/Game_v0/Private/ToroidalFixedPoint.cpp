@@ -0,0 +1,80 @@
+#include "ToroidalFixedPoint.h"
+
+namespace
+{
+    // Scale and round into the low 32 bits. Scales are powers of two, which
+    // double multiplies exactly, so this is deterministic.
+    uint32 ToFixedAxis(double Value, double Scale)
+    {
+        const int64 Scaled = static_cast<int64>(FMath::RoundToDouble(Value * Scale));
+        return static_cast<uint32>(Scaled);
+    }
+
+    constexpr double TwoToThe32 = 4294967296.0;
+
+    // Z range in common units, keeping any Z delta inside int32
+    constexpr int64 MaxZ = (int64(1) << 30) - 1;
+}
+
+bool FToroidalFixedSpace::IsValidWorldSize(float Size)
+{
+    if (Size < 2.0f || Size > static_cast<float>(1 << 30))
+    {
+        return false;
+    }
+
+    const uint32 IntSize = static_cast<uint32>(Size);
+    return static_cast<float>(IntSize) == Size && FMath::IsPowerOfTwo(IntSize);
+}
+
+bool FToroidalFixedSpace::Initialize(float WorldWidth, float WorldHeight)
+{
+    BitsX = 0;
+    BitsY = 0;
+
+    if (!IsValidWorldSize(WorldWidth) || !IsValidWorldSize(WorldHeight))
+    {
+        return false;
+    }
+
+    BitsX = FMath::FloorLog2(static_cast<uint32>(WorldWidth));
+    BitsY = FMath::FloorLog2(static_cast<uint32>(WorldHeight));
+
+    // The larger axis defines the common unit
+    const int32 MaxBits = FMath::Max(BitsX, BitsY);
+    ShiftX = MaxBits - BitsX;
+    ShiftY = MaxBits - BitsY;
+    ScaleX = TwoToThe32 / static_cast<double>(1u << BitsX);
+    ScaleY = TwoToThe32 / static_cast<double>(1u << BitsY);
+    UnitSize = static_cast<double>(1u << MaxBits) / TwoToThe32;
+
+    return true;
+}
+
+FToroidalFixedCoordinate FToroidalFixedSpace::FromToroidal(const FVector& ToroidalPosition) const
+{
+    return FToroidalFixedCoordinate(
+        ToFixedAxis(ToroidalPosition.X, ScaleX),
+        ToFixedAxis(ToroidalPosition.Y, ScaleY),
+        static_cast<int32>(FMath::Clamp(static_cast<int64>(FMath::RoundToDouble(ToroidalPosition.Z / UnitSize)), -MaxZ, MaxZ)));
+}
+
+FVector FToroidalFixedSpace::ToToroidal(const FToroidalFixedCoordinate& Coordinate) const
+{
+    // Signed reinterpretation gives the centered range
+    return FVector(
+        static_cast<double>(static_cast<int32>(Coordinate.X)) / ScaleX,
+        static_cast<double>(static_cast<int32>(Coordinate.Y)) / ScaleY,
+        ToCentimeters(Coordinate.Z));
+}
+
+FVector FToroidalFixedSpace::GetDeltaVector(const FToroidalFixedCoordinate& From, const FToroidalFixedCoordinate& To) const
+{
+    const FIntVector Delta = GetDelta(From, To);
+    return FVector(ToCentimeters(Delta.X), ToCentimeters(Delta.Y), ToCentimeters(Delta.Z));
+}
+
+float FToroidalFixedSpace::GetDistance(const FToroidalFixedCoordinate& From, const FToroidalFixedCoordinate& To) const
+{
+    return static_cast<float>(FMath::Sqrt(static_cast<double>(GetDistanceSquared(From, To))) * UnitSize);
+}
@@ -0,0 +1,310 @@
+#include "ToroidalMath.h"
+#include "Toroid.h"
+#include "Math/VectorRegister.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace ToroidalMathPrivate
+{
+    constexpr int32 Lanes = 4;
+
+    FORCEINLINE float WrapScalar(float Value, float Size, float InvSize)
+    {
+        return Value - Size * FMath::FloorToFloat(Value * InvSize + 0.5f);
+    }
+
+    FORCEINLINE VectorRegister4Float VectorWrap(const VectorRegister4Float& Value, const VectorRegister4Float& Size, const VectorRegister4Float& InvSize)
+    {
+        // Value - Size * floor(Value / Size + 0.5)
+        const VectorRegister4Float Cells = VectorFloor(VectorMultiplyAdd(Value, InvSize, GlobalVectorConstants::FloatOneHalf));
+        return VectorNegateMultiplyAdd(Size, Cells, Value);
+    }
+
+    FORCEINLINE VectorRegister4Float VectorLengthSquared3(const VectorRegister4Float& DX, const VectorRegister4Float& DY, const VectorRegister4Float& DZ)
+    {
+        return VectorMultiplyAdd(DZ, DZ, VectorMultiplyAdd(DY, DY, VectorMultiply(DX, DX)));
+    }
+}
+
+void FToroidalMath::NormalizeBatch(TArrayView<float> X, TArrayView<float> Y, float WorldWidth, float WorldHeight)
+{
+    using namespace ToroidalMathPrivate;
+    check(X.Num() == Y.Num());
+
+    const int32 Count = X.Num();
+    const float InvWidth = 1.0f / WorldWidth;
+    const float InvHeight = 1.0f / WorldHeight;
+
+    const VectorRegister4Float Width = VectorSetFloat1(WorldWidth);
+    const VectorRegister4Float Height = VectorSetFloat1(WorldHeight);
+    const VectorRegister4Float InvWidthV = VectorSetFloat1(InvWidth);
+    const VectorRegister4Float InvHeightV = VectorSetFloat1(InvHeight);
+
+    float* RESTRICT XData = X.GetData();
+    float* RESTRICT YData = Y.GetData();
+
+    int32 i = 0;
+    for (; i + Lanes <= Count; i += Lanes)
+    {
+        VectorStore(VectorWrap(VectorLoad(XData + i), Width, InvWidthV), XData + i);
+        VectorStore(VectorWrap(VectorLoad(YData + i), Height, InvHeightV), YData + i);
+    }
+
+    for (; i < Count; ++i)
+    {
+        XData[i] = WrapScalar(XData[i], WorldWidth, InvWidth);
+        YData[i] = WrapScalar(YData[i], WorldHeight, InvHeight);
+    }
+}
+
+void FToroidalMath::PairwiseDistanceBatch(
+    TArrayView<const float> AX, TArrayView<const float> AY, TArrayView<const float> AZ,
+    TArrayView<const float> BX, TArrayView<const float> BY, TArrayView<const float> BZ,
+    float WorldWidth, float WorldHeight, TArrayView<float> OutDistances)
+{
+    using namespace ToroidalMathPrivate;
+
+    const int32 Count = OutDistances.Num();
+    check(AX.Num() == Count && AY.Num() == Count && AZ.Num() == Count);
+    check(BX.Num() == Count && BY.Num() == Count && BZ.Num() == Count);
+
+    const float InvWidth = 1.0f / WorldWidth;
+    const float InvHeight = 1.0f / WorldHeight;
+
+    const VectorRegister4Float Width = VectorSetFloat1(WorldWidth);
+    const VectorRegister4Float Height = VectorSetFloat1(WorldHeight);
+    const VectorRegister4Float InvWidthV = VectorSetFloat1(InvWidth);
+    const VectorRegister4Float InvHeightV = VectorSetFloat1(InvHeight);
+
+    int32 i = 0;
+    for (; i + Lanes <= Count; i += Lanes)
+    {
+        const VectorRegister4Float DX = VectorWrap(VectorSubtract(VectorLoad(BX.GetData() + i), VectorLoad(AX.GetData() + i)), Width, InvWidthV);
+        const VectorRegister4Float DY = VectorWrap(VectorSubtract(VectorLoad(BY.GetData() + i), VectorLoad(AY.GetData() + i)), Height, InvHeightV);
+        const VectorRegister4Float DZ = VectorSubtract(VectorLoad(BZ.GetData() + i), VectorLoad(AZ.GetData() + i));
+        VectorStore(VectorSqrt(VectorLengthSquared3(DX, DY, DZ)), OutDistances.GetData() + i);
+    }
+
+    for (; i < Count; ++i)
+    {
+        const float DX = WrapScalar(BX[i] - AX[i], WorldWidth, InvWidth);
+        const float DY = WrapScalar(BY[i] - AY[i], WorldHeight, InvHeight);
+        const float DZ = BZ[i] - AZ[i];
+        OutDistances[i] = FMath::Sqrt(DX * DX + DY * DY + DZ * DZ);
+    }
+}
+
+void FToroidalMath::OneToManyDistanceSquaredBatch(
+    const FVector3f& Origin,
+    TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z,
+    float WorldWidth, float WorldHeight, TArrayView<float> OutDistancesSquared)
+{
+    using namespace ToroidalMathPrivate;
+
+    const int32 Count = OutDistancesSquared.Num();
+    check(X.Num() == Count && Y.Num() == Count && Z.Num() == Count);
+
+    const float InvWidth = 1.0f / WorldWidth;
+    const float InvHeight = 1.0f / WorldHeight;
+
+    const VectorRegister4Float Width = VectorSetFloat1(WorldWidth);
+    const VectorRegister4Float Height = VectorSetFloat1(WorldHeight);
+    const VectorRegister4Float InvWidthV = VectorSetFloat1(InvWidth);
+    const VectorRegister4Float InvHeightV = VectorSetFloat1(InvHeight);
+    const VectorRegister4Float OriginX = VectorSetFloat1(Origin.X);
+    const VectorRegister4Float OriginY = VectorSetFloat1(Origin.Y);
+    const VectorRegister4Float OriginZ = VectorSetFloat1(Origin.Z);
+
+    int32 i = 0;
+    for (; i + Lanes <= Count; i += Lanes)
+    {
+        const VectorRegister4Float DX = VectorWrap(VectorSubtract(VectorLoad(X.GetData() + i), OriginX), Width, InvWidthV);
+        const VectorRegister4Float DY = VectorWrap(VectorSubtract(VectorLoad(Y.GetData() + i), OriginY), Height, InvHeightV);
+        const VectorRegister4Float DZ = VectorSubtract(VectorLoad(Z.GetData() + i), OriginZ);
+        VectorStore(VectorLengthSquared3(DX, DY, DZ), OutDistancesSquared.GetData() + i);
+    }
+
+    for (; i < Count; ++i)
+    {
+        const float DX = WrapScalar(X[i] - Origin.X, WorldWidth, InvWidth);
+        const float DY = WrapScalar(Y[i] - Origin.Y, WorldHeight, InvHeight);
+        const float DZ = Z[i] - Origin.Z;
+        OutDistancesSquared[i] = DX * DX + DY * DY + DZ * DZ;
+    }
+}
+
+void FToroidalMath::OneToManyDistanceBatch(
+    const FVector3f& Origin,
+    TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z,
+    float WorldWidth, float WorldHeight, TArrayView<float> OutDistances)
+{
+    using namespace ToroidalMathPrivate;
+
+    OneToManyDistanceSquaredBatch(Origin, X, Y, Z, WorldWidth, WorldHeight, OutDistances);
+
+    const int32 Count = OutDistances.Num();
+    float* RESTRICT Data = OutDistances.GetData();
+
+    int32 i = 0;
+    for (; i + Lanes <= Count; i += Lanes)
+    {
+        VectorStore(VectorSqrt(VectorLoad(Data + i)), Data + i);
+    }
+
+    for (; i < Count; ++i)
+    {
+        Data[i] = FMath::Sqrt(Data[i]);
+    }
+}
+
+void FToroidalMath::DirectionBatch(
+    TArrayView<const float> AX, TArrayView<const float> AY, TArrayView<const float> AZ,
+    TArrayView<const float> BX, TArrayView<const float> BY, TArrayView<const float> BZ,
+    float WorldWidth, float WorldHeight,
+    TArrayView<float> OutX, TArrayView<float> OutY, TArrayView<float> OutZ)
+{
+    using namespace ToroidalMathPrivate;
+
+    const int32 Count = OutX.Num();
+    check(OutY.Num() == Count && OutZ.Num() == Count);
+    check(AX.Num() == Count && AY.Num() == Count && AZ.Num() == Count);
+    check(BX.Num() == Count && BY.Num() == Count && BZ.Num() == Count);
+
+    const float InvWidth = 1.0f / WorldWidth;
+    const float InvHeight = 1.0f / WorldHeight;
+
+    const VectorRegister4Float Width = VectorSetFloat1(WorldWidth);
+    const VectorRegister4Float Height = VectorSetFloat1(WorldHeight);
+    const VectorRegister4Float InvWidthV = VectorSetFloat1(InvWidth);
+    const VectorRegister4Float InvHeightV = VectorSetFloat1(InvHeight);
+    const VectorRegister4Float Epsilon = VectorSetFloat1(UE_SMALL_NUMBER);
+
+    int32 i = 0;
+    for (; i + Lanes <= Count; i += Lanes)
+    {
+        const VectorRegister4Float DX = VectorWrap(VectorSubtract(VectorLoad(BX.GetData() + i), VectorLoad(AX.GetData() + i)), Width, InvWidthV);
+        const VectorRegister4Float DY = VectorWrap(VectorSubtract(VectorLoad(BY.GetData() + i), VectorLoad(AY.GetData() + i)), Height, InvHeightV);
+        const VectorRegister4Float DZ = VectorSubtract(VectorLoad(BZ.GetData() + i), VectorLoad(AZ.GetData() + i));
+
+        // Same contract as FVector::GetSafeNormal: zero for degenerate input
+        const VectorRegister4Float LengthSquared = VectorLengthSquared3(DX, DY, DZ);
+        const VectorRegister4Float InvLength = VectorSelect(
+            VectorCompareGT(LengthSquared, Epsilon),
+            VectorReciprocalSqrt(LengthSquared),
+            VectorZeroFloat());
+
+        VectorStore(VectorMultiply(DX, InvLength), OutX.GetData() + i);
+        VectorStore(VectorMultiply(DY, InvLength), OutY.GetData() + i);
+        VectorStore(VectorMultiply(DZ, InvLength), OutZ.GetData() + i);
+    }
+
+    for (; i < Count; ++i)
+    {
+        const FVector3f Delta(
+            WrapScalar(BX[i] - AX[i], WorldWidth, InvWidth),
+            WrapScalar(BY[i] - AY[i], WorldHeight, InvHeight),
+            BZ[i] - AZ[i]);
+        const FVector3f Direction = Delta.GetSafeNormal();
+        OutX[i] = Direction.X;
+        OutY[i] = Direction.Y;
+        OutZ[i] = Direction.Z;
+    }
+}
+
+#if !UE_BUILD_SHIPPING
+
+// Toroid.BenchmarkMath [Count] [Iterations]
+// Compares the per-call manager functions with the batched paths on random positions
+static void RunToroidalMathBenchmark(const TArray<FString>& Args)
+{
+    const int32 Count = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+    const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100;
+
+    const UToroidalWorldManager* Manager = GetDefault<UToroidalWorldManager>();
+    const float Width = Manager->WorldWidth;
+    const float Height = Manager->WorldHeight;
+
+    // Positions scattered over three world sizes so normalization has real work to do
+    FRandomStream Random(1234);
+    TArray<FVector> Positions;
+    TArray<float> X, Y, Z;
+    Positions.SetNumUninitialized(Count);
+    X.SetNumUninitialized(Count);
+    Y.SetNumUninitialized(Count);
+    Z.SetNumUninitialized(Count);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        Positions[i] = FVector(Random.FRandRange(-1.5f, 1.5f) * Width, Random.FRandRange(-1.5f, 1.5f) * Height, Random.FRandRange(0.0f, 200.0f));
+        X[i] = Positions[i].X - Manager->WorldCenter.X;
+        Y[i] = Positions[i].Y - Manager->WorldCenter.Y;
+        Z[i] = Positions[i].Z - Manager->WorldCenter.Z;
+    }
+
+    const FVector Origin = Manager->WorldCenter + FVector(Width * 0.45f, -Height * 0.45f, 0.0f);
+    const FVector3f OriginToroidal(Origin - Manager->WorldCenter);
+
+    TArray<float> ScalarDistances, BatchDistances;
+    ScalarDistances.SetNumUninitialized(Count);
+    BatchDistances.SetNumUninitialized(Count);
+
+    // Scalar: one manager call per pair
+    double Start = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        for (int32 i = 0; i < Count; ++i)
+        {
+            ScalarDistances[i] = Manager->GetToroidalDistance(Origin, Positions[i]);
+        }
+    }
+    const double ScalarDistanceMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+    // Batched one-to-many
+    Start = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        FToroidalMath::OneToManyDistanceBatch(OriginToroidal, X, Y, Z, Width, Height, BatchDistances);
+    }
+    const double BatchDistanceMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+    float MaxError = 0.0f;
+    for (int32 i = 0; i < Count; ++i)
+    {
+        MaxError = FMath::Max(MaxError, FMath::Abs(ScalarDistances[i] - BatchDistances[i]));
+    }
+
+    // Scalar vs batched normalization
+    float Checksum = 0.0f;
+    Start = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        for (int32 i = 0; i < Count; ++i)
+        {
+            Checksum += Manager->NormalizeToroidalCoordinate(FToroidalCoordinate(X[i], Y[i], Z[i])).X;
+        }
+    }
+    const double ScalarNormalizeMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+    TArray<float> NormalizedX, NormalizedY;
+    Start = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        NormalizedX = X;
+        NormalizedY = Y;
+        FToroidalMath::NormalizeBatch(NormalizedX, NormalizedY, Width, Height);
+        Checksum += NormalizedX[0];
+    }
+    const double BatchNormalizeMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+    UE_LOG(LogTemp, Log, TEXT("Toroidal math benchmark: %d positions x %d iterations"), Count, Iterations);
+    UE_LOG(LogTemp, Log, TEXT("  Distance  scalar %.3f ms, batch %.3f ms (x%.1f), max error %f"),
+           ScalarDistanceMs, BatchDistanceMs, ScalarDistanceMs / FMath::Max(BatchDistanceMs, 0.001), MaxError);
+    UE_LOG(LogTemp, Log, TEXT("  Normalize scalar %.3f ms, batch %.3f ms (x%.1f), checksum %f"),
+           ScalarNormalizeMs, BatchNormalizeMs, ScalarNormalizeMs / FMath::Max(BatchNormalizeMs, 0.001), Checksum);
+}
+
+static FAutoConsoleCommand ToroidalMathBenchmarkCommand(
+    TEXT("Toroid.BenchmarkMath"),
+    TEXT("Compare scalar and batched toroidal math. Usage: Toroid.BenchmarkMath [Count] [Iterations]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunToroidalMathBenchmark));
+
+#endif
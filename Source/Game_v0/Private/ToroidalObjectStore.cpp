@@ -0,0 +1,101 @@
+#include "ToroidalObjectStore.h"
+
+FToroidalHandle FToroidalObjectStore::Add(AActor* Actor)
+{
+    const int32 SlotIndex = FreeSlots.Num() > 0 ? FreeSlots.Pop(EAllowShrinking::No) : Slots.AddDefaulted();
+    FSlot& Slot = Slots[SlotIndex];
+    Slot.DenseIndex = Actors.Num();
+
+    Actors.Add(Actor);
+    PositionX.Add(0.0f);
+    PositionY.Add(0.0f);
+    PositionZ.Add(0.0f);
+    EdgeFlags.Add(EToroidalEdgeFlags::None);
+    Ghosts.AddDefaulted();
+    TransformUpdatedHandles.AddDefaulted();
+    DirtyFlags.Add(false);
+    DenseToSlot.Add(SlotIndex);
+
+    return FToroidalHandle(SlotIndex, Slot.Generation);
+}
+
+bool FToroidalObjectStore::Remove(FToroidalHandle Handle)
+{
+    const int32 DenseIndex = GetDenseIndex(Handle);
+    if (DenseIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    // The last element moves into the hole; repoint its slot
+    const int32 LastIndex = Actors.Num() - 1;
+    if (DenseIndex != LastIndex)
+    {
+        Slots[DenseToSlot[LastIndex]].DenseIndex = DenseIndex;
+    }
+
+    Actors.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    PositionX.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    PositionY.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    PositionZ.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    EdgeFlags.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    Ghosts.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    TransformUpdatedHandles.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    DirtyFlags.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    DenseToSlot.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+
+    // Bumping the generation makes every outstanding handle to this slot stale
+    FSlot& Slot = Slots[Handle.Index];
+    Slot.DenseIndex = INDEX_NONE;
+    ++Slot.Generation;
+    FreeSlots.Add(Handle.Index);
+
+    return true;
+}
+
+void FToroidalObjectStore::Empty()
+{
+    Actors.Empty();
+    PositionX.Empty();
+    PositionY.Empty();
+    PositionZ.Empty();
+    EdgeFlags.Empty();
+    Ghosts.Empty();
+    TransformUpdatedHandles.Empty();
+    DirtyFlags.Empty();
+    DenseToSlot.Empty();
+
+    // Keep the slots so old handles stay stale instead of aliasing new objects
+    FreeSlots.Reset();
+    for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+    {
+        if (Slots[SlotIndex].DenseIndex != INDEX_NONE)
+        {
+            Slots[SlotIndex].DenseIndex = INDEX_NONE;
+            ++Slots[SlotIndex].Generation;
+        }
+        FreeSlots.Add(SlotIndex);
+    }
+}
+
+int32 FToroidalObjectStore::GetDenseIndex(FToroidalHandle Handle) const
+{
+    if (!Slots.IsValidIndex(Handle.Index))
+    {
+        return INDEX_NONE;
+    }
+
+    const FSlot& Slot = Slots[Handle.Index];
+    return Slot.Generation == Handle.Generation ? Slot.DenseIndex : INDEX_NONE;
+}
+
+FToroidalHandle FToroidalObjectStore::GetHandle(int32 DenseIndex) const
+{
+    if (!DenseToSlot.IsValidIndex(DenseIndex))
+    {
+        return FToroidalHandle();
+    }
+
+    const int32 SlotIndex = DenseToSlot[DenseIndex];
+    return FToroidalHandle(SlotIndex, Slots[SlotIndex].Generation);
+}
@@ -0,0 +1,144 @@
+#include "ToroidalSpatialGrid.h"
+#include "Toroid.h"
+#include "Math/UnrealMathUtility.h"
+
+FToroidalSpatialGrid::FToroidalSpatialGrid()
+    : WorldWidth(0.0f)
+    , WorldHeight(0.0f)
+    , CellSizeX(1.0f)
+    , CellSizeY(1.0f)
+    , NumCellsX(0)
+    , NumCellsY(0)
+{
+}
+
+void FToroidalSpatialGrid::Initialize(float InWorldWidth, float InWorldHeight, float InCellSize)
+{
+    WorldWidth = FMath::Max(InWorldWidth, 1.0f);
+    WorldHeight = FMath::Max(InWorldHeight, 1.0f);
+
+    const float RequestedCellSize = FMath::Max(InCellSize, 1.0f);
+
+    // Cells must tile the world exactly, otherwise the last column would be
+    // narrower than the others and the modulo wrap would skip space
+    NumCellsX = FMath::Max(1, FMath::FloorToInt(WorldWidth / RequestedCellSize));
+    NumCellsY = FMath::Max(1, FMath::FloorToInt(WorldHeight / RequestedCellSize));
+    CellSizeX = WorldWidth / NumCellsX;
+    CellSizeY = WorldHeight / NumCellsY;
+
+    Cells.Reset();
+    Cells.SetNum(NumCellsX * NumCellsY);
+    ActorCells.Reset();
+}
+
+void FToroidalSpatialGrid::Reset()
+{
+    for (TArray<FToroidalGridEntry>& Cell : Cells)
+    {
+        Cell.Reset();
+    }
+    ActorCells.Reset();
+}
+
+FIntPoint FToroidalSpatialGrid::GetCellCoords(const FToroidalCoordinate& NormalizedPosition) const
+{
+    // Shift from [-Half, Half] into [0, Size]
+    const int32 CellX = FMath::FloorToInt((NormalizedPosition.X + WorldWidth * 0.5f) / CellSizeX);
+    const int32 CellY = FMath::FloorToInt((NormalizedPosition.Y + WorldHeight * 0.5f) / CellSizeY);
+    return FIntPoint(CellX, CellY);
+}
+
+int32 FToroidalSpatialGrid::GetCellIndex(int32 CellX, int32 CellY) const
+{
+    // Positive modulo so negative cells wrap to the far side
+    const int32 WrappedX = ((CellX % NumCellsX) + NumCellsX) % NumCellsX;
+    const int32 WrappedY = ((CellY % NumCellsY) + NumCellsY) % NumCellsY;
+    return WrappedY * NumCellsX + WrappedX;
+}
+
+void FToroidalSpatialGrid::AddOrUpdate(AActor* Actor, const FToroidalCoordinate& NormalizedPosition)
+{
+    if (!Actor || Cells.Num() == 0)
+    {
+        return;
+    }
+
+    const TWeakObjectPtr<AActor> Key(Actor);
+    const FIntPoint Coords = GetCellCoords(NormalizedPosition);
+    const int32 NewCell = GetCellIndex(Coords.X, Coords.Y);
+
+    if (int32* CurrentCell = ActorCells.Find(Key))
+    {
+        TArray<FToroidalGridEntry>& OldEntries = Cells[*CurrentCell];
+        const int32 EntryIndex = OldEntries.IndexOfByPredicate([&Key](const FToroidalGridEntry& Entry) {
+            return Entry.Actor == Key;
+        });
+
+        if (*CurrentCell == NewCell && EntryIndex != INDEX_NONE)
+        {
+            // Same cell, just refresh the cached position
+            OldEntries[EntryIndex].Position = NormalizedPosition.ToVector();
+            return;
+        }
+
+        if (EntryIndex != INDEX_NONE)
+        {
+            OldEntries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+        }
+        *CurrentCell = NewCell;
+    }
+    else
+    {
+        ActorCells.Add(Key, NewCell);
+    }
+
+    Cells[NewCell].Emplace(Actor, NormalizedPosition.ToVector());
+}
+
+void FToroidalSpatialGrid::Remove(const TWeakObjectPtr<AActor>& Actor)
+{
+    int32 CellIndex = INDEX_NONE;
+    if (!ActorCells.RemoveAndCopyValue(Actor, CellIndex) || !Cells.IsValidIndex(CellIndex))
+    {
+        return;
+    }
+
+    TArray<FToroidalGridEntry>& Entries = Cells[CellIndex];
+    const int32 EntryIndex = Entries.IndexOfByPredicate([&Actor](const FToroidalGridEntry& Entry) {
+        return Entry.Actor == Actor;
+    });
+    if (EntryIndex != INDEX_NONE)
+    {
+        Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+    }
+}
+
+void FToroidalSpatialGrid::GatherCandidates(const FToroidalCoordinate& Center, float HalfExtentX, float HalfExtentY, TArray<FToroidalGridEntry>& OutEntries) const
+{
+    if (Cells.Num() == 0)
+    {
+        return;
+    }
+
+    const FIntPoint MinCell = GetCellCoords(FToroidalCoordinate(Center.X - HalfExtentX, Center.Y - HalfExtentY, Center.Z));
+    const FIntPoint MaxCell = GetCellCoords(FToroidalCoordinate(Center.X + HalfExtentX, Center.Y + HalfExtentY, Center.Z));
+
+    // A query wider than the world must not visit the same column twice
+    const int32 SpanX = FMath::Min(MaxCell.X - MinCell.X + 1, NumCellsX);
+    const int32 SpanY = FMath::Min(MaxCell.Y - MinCell.Y + 1, NumCellsY);
+
+    for (int32 OffsetY = 0; OffsetY < SpanY; ++OffsetY)
+    {
+        for (int32 OffsetX = 0; OffsetX < SpanX; ++OffsetX)
+        {
+            const TArray<FToroidalGridEntry>& Entries = Cells[GetCellIndex(MinCell.X + OffsetX, MinCell.Y + OffsetY)];
+            for (const FToroidalGridEntry& Entry : Entries)
+            {
+                if (Entry.Actor.IsValid())
+                {
+                    OutEntries.Add(Entry);
+                }
+            }
+        }
+    }
+}
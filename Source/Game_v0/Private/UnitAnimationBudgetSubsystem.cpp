@@ -0,0 +1,130 @@
+#include "UnitAnimationBudgetSubsystem.h"
+#include "UnitBase.h"
+#include "UnitTickSubsystem.h"
+#include "Toroid.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Unit Animation Budget"), STAT_UnitAnimationBudget, STATGROUP_Game);
+
+namespace
+{
+    // Counts as on screen if drawn within this many seconds
+    constexpr float RecentlyRenderedTolerance = 0.2f;
+
+    // Weight of a new frame's measurement in the smoothed update cost
+    constexpr float CostSmoothing = 0.1f;
+}
+
+bool UUnitAnimationBudgetSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UUnitAnimationBudgetSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitAnimationBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UUnitAnimationBudgetSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_UnitAnimationBudget);
+
+    const UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>();
+    if (!UnitTick)
+    {
+        return;
+    }
+
+    // Meshes ticked before us this frame, at the rates planned last frame
+    if (UpdateCostMs < 0.0f)
+    {
+        UpdateCostMs = InitialUpdateCostMs;
+    }
+    MeasuredCostMs = static_cast<float>(PendingMeasuredMs);
+    if (PlannedUpdates > 0.0f && MeasuredCostMs > 0.0f)
+    {
+        UpdateCostMs = FMath::Lerp(UpdateCostMs, MeasuredCostMs / PlannedUpdates, CostSmoothing);
+    }
+    PendingMeasuredMs = 0.0;
+
+    // Local cameras only; remote players animate on their own machines
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        if (PC && PC->IsLocalController())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            ViewLocations.Add(ViewLocation);
+        }
+    }
+
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+
+    RankedUnits.Reset();
+    for (AUnitBase* Unit : UnitTick->GetRegisteredUnits())
+    {
+        const USkeletalMeshComponent* MeshComp = Unit->GetMesh();
+        if (!MeshComp || !MeshComp->WasRecentlyRendered(RecentlyRenderedTolerance))
+        {
+            continue;
+        }
+
+        FRankedUnit& Ranked = RankedUnits.AddDefaulted_GetRef();
+        Ranked.Unit = Unit;
+        Ranked.bSelected = Unit->GetIsSelected();
+        Ranked.Distance = TNumericLimits<float>::Max();
+        for (const FVector& ViewLocation : ViewLocations)
+        {
+            // Units just across a seam are drawn right next to the camera
+            const float Distance = ToroidalWorld ? ToroidalWorld->GetToroidalDistance(ViewLocation, Unit->GetActorLocation())
+                                                 : FVector::Dist(ViewLocation, Unit->GetActorLocation());
+            Ranked.Distance = FMath::Min(Ranked.Distance, Distance);
+        }
+    }
+
+    RankedUnits.Sort([](const FRankedUnit& A, const FRankedUnit& B)
+    {
+        return A.bSelected != B.bSelected ? A.bSelected : A.Distance < B.Distance;
+    });
+
+    const int32 SlowestRate = FMath::Clamp(MaxTickRate, 2, 30);
+    float SpentMs = 0.0f;
+    NumThrottledUnits = 0;
+
+    for (const FRankedUnit& Ranked : RankedUnits)
+    {
+        int32 TickRate = 1;
+        if (!Ranked.bSelected)
+        {
+            TickRate = Ranked.Distance <= FullRateDistance ? 1 : (Ranked.Distance <= ReducedRateDistance ? 2 : SlowestRate);
+
+            // Out of budget: everything further down runs at the slowest rate
+            if (SpentMs + UpdateCostMs / TickRate > BudgetMs)
+            {
+                TickRate = SlowestRate;
+                ++NumThrottledUnits;
+            }
+        }
+
+        SpentMs += UpdateCostMs / TickRate;
+        ApplyTickRate(Ranked.Unit, TickRate);
+    }
+
+    PlannedUpdates = SpentMs / UpdateCostMs;
+}
+
+void UUnitAnimationBudgetSubsystem::ApplyTickRate(AUnitBase* Unit, int32 TickRate)
+{
+    USkeletalMeshComponent* MeshComp = Unit->GetMesh();
+
+    // Skipped frames are interpolated so slow units still move smoothly
+    MeshComp->EnableExternalTickRateControl(true);
+    MeshComp->SetExternalTickRate(static_cast<uint8>(TickRate));
+    MeshComp->EnableExternalInterpolation(TickRate > 1);
+}
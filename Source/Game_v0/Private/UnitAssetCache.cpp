@@ -0,0 +1,136 @@
+#include "UnitAssetCache.h"
+#include "UnitBase.h"
+#include "Race_base.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+void UUnitAssetCache::Deinitialize()
+{
+    for (TPair<FSoftObjectPath, FCachedAsset>& Pair : Assets)
+    {
+        if (Pair.Value.Handle.IsValid())
+        {
+            Pair.Value.Handle->ReleaseHandle();
+        }
+    }
+    Assets.Empty();
+
+    Super::Deinitialize();
+}
+
+UUnitAssetCache* UUnitAssetCache::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+    return GameInstance ? GameInstance->GetSubsystem<UUnitAssetCache>() : nullptr;
+}
+
+void UUnitAssetCache::Load(const UObject* Requester, const FSoftObjectPath& Path, FSimpleDelegate OnLoaded)
+{
+    if (UUnitAssetCache* Cache = Get(Requester))
+    {
+        Cache->RequestAsset(Path, MoveTemp(OnLoaded));
+        return;
+    }
+
+    UAssetManager::GetStreamableManager().RequestAsyncLoad(Path, FStreamableDelegate::CreateLambda([OnLoaded]()
+    {
+        OnLoaded.ExecuteIfBound();
+    }));
+}
+
+void UUnitAssetCache::RequestAsset(const FSoftObjectPath& Path, FSimpleDelegate OnLoaded)
+{
+    if (Path.IsNull())
+    {
+        return;
+    }
+
+    FCachedAsset& Asset = Assets.FindOrAdd(Path);
+    if (Asset.bLoaded)
+    {
+        OnLoaded.ExecuteIfBound();
+        return;
+    }
+
+    if (OnLoaded.IsBound())
+    {
+        Asset.Waiters.Add(MoveTemp(OnLoaded));
+    }
+
+    // Someone already asked; the load in flight will call us too
+    if (Asset.Handle.IsValid())
+    {
+        return;
+    }
+
+    // May complete right here if the asset is already in memory, so don't
+    // hold on to the Asset reference across it
+    TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+        Path, FStreamableDelegate::CreateUObject(this, &UUnitAssetCache::OnAssetLoaded, Path));
+
+    if (FCachedAsset* Cached = Assets.Find(Path))
+    {
+        Cached->Handle = Handle;
+    }
+}
+
+void UUnitAssetCache::OnAssetLoaded(FSoftObjectPath Path)
+{
+    FCachedAsset* Asset = Assets.Find(Path);
+    if (!Asset)
+    {
+        return;
+    }
+
+    Asset->bLoaded = true;
+    if (!Path.ResolveObject())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("UnitAssetCache: Failed to load %s"), *Path.ToString());
+    }
+
+    // Callbacks may request more assets, which can reallocate the map
+    TArray<FSimpleDelegate> Waiters = MoveTemp(Asset->Waiters);
+    for (const FSimpleDelegate& Waiter : Waiters)
+    {
+        Waiter.ExecuteIfBound();
+    }
+}
+
+void UUnitAssetCache::PreloadUnitClass(TSubclassOf<AUnitBase> UnitClass)
+{
+    if (!UnitClass)
+    {
+        return;
+    }
+
+    TArray<FSoftObjectPath> Paths;
+    UnitClass->GetDefaultObject<AUnitBase>()->GetAssetsToPreload(Paths);
+
+    for (const FSoftObjectPath& Path : Paths)
+    {
+        RequestAsset(Path, FSimpleDelegate());
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("UnitAssetCache: Preloading %d assets for %s"), Paths.Num(), *UnitClass->GetName());
+}
+
+void UUnitAssetCache::PreloadRace(TSubclassOf<URace_base> RaceClass)
+{
+    if (!RaceClass)
+    {
+        return;
+    }
+
+    for (const TSubclassOf<AUnitBase>& UnitClass : RaceClass->GetDefaultObject<URace_base>()->GetUnitClasses())
+    {
+        PreloadUnitClass(UnitClass);
+    }
+}
+
+bool UUnitAssetCache::IsAssetLoaded(const FSoftObjectPath& Path) const
+{
+    const FCachedAsset* Asset = Assets.Find(Path);
+    return Asset && Asset->bLoaded;
+}
@@ -0,0 +1,467 @@
+#include "UnitAvoidanceSubsystem.h"
+#include "UnitMovementComponent.h"
+#include "Toroid.h"
+#include "ToroidalMath.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Unit Avoidance"), STAT_UnitAvoidance, STATGROUP_Game);
+
+namespace
+{
+    // Agents per ParallelFor task
+    constexpr int32 SolveChunkSize = 256;
+
+    constexpr float OrcaEpsilon = 1e-5f;
+
+    // Allowed velocities lie on the left of Direction through Point
+    struct FOrcaLine
+    {
+        FVector2f Point;
+        FVector2f Direction;
+    };
+
+    using FOrcaLines = TArray<FOrcaLine, TInlineAllocator<16>>;
+
+    FORCEINLINE float Det(const FVector2f& A, const FVector2f& B)
+    {
+        return A.X * B.Y - A.Y * B.X;
+    }
+
+    // Best velocity on line LineNo that satisfies the lines before it
+    bool SolveOnLine(const FOrcaLines& Lines, int32 LineNo, float MaxSpeed, const FVector2f& Preferred, bool bDirectionOpt, FVector2f& Result)
+    {
+        const FOrcaLine& Line = Lines[LineNo];
+        const float DotProduct = Line.Point | Line.Direction;
+        const float Discriminant = FMath::Square(DotProduct) + FMath::Square(MaxSpeed) - Line.Point.SizeSquared();
+        if (Discriminant < 0.0f)
+        {
+            // Max speed circle misses the line entirely
+            return false;
+        }
+
+        const float SqrtDiscriminant = FMath::Sqrt(Discriminant);
+        float TLeft = -DotProduct - SqrtDiscriminant;
+        float TRight = -DotProduct + SqrtDiscriminant;
+
+        for (int32 i = 0; i < LineNo; ++i)
+        {
+            const float Denominator = Det(Line.Direction, Lines[i].Direction);
+            const float Numerator = Det(Lines[i].Direction, Line.Point - Lines[i].Point);
+
+            if (FMath::Abs(Denominator) <= OrcaEpsilon)
+            {
+                // Parallel; either all of this line is allowed or none of it
+                if (Numerator < 0.0f)
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const float T = Numerator / Denominator;
+            if (Denominator >= 0.0f)
+            {
+                TRight = FMath::Min(TRight, T);
+            }
+            else
+            {
+                TLeft = FMath::Max(TLeft, T);
+            }
+
+            if (TLeft > TRight)
+            {
+                return false;
+            }
+        }
+
+        if (bDirectionOpt)
+        {
+            Result = Line.Point + Line.Direction * ((Preferred | Line.Direction) > 0.0f ? TRight : TLeft);
+        }
+        else
+        {
+            const float T = FMath::Clamp(Line.Direction | (Preferred - Line.Point), TLeft, TRight);
+            Result = Line.Point + Line.Direction * T;
+        }
+        return true;
+    }
+
+    // Velocity closest to Preferred within every line and MaxSpeed. Returns the
+    // number of lines satisfied; fewer than Lines.Num() means it is infeasible.
+    int32 SolveLines(const FOrcaLines& Lines, float MaxSpeed, const FVector2f& Preferred, bool bDirectionOpt, FVector2f& Result)
+    {
+        if (bDirectionOpt)
+        {
+            Result = Preferred * MaxSpeed;
+        }
+        else if (Preferred.SizeSquared() > FMath::Square(MaxSpeed))
+        {
+            Result = Preferred.GetSafeNormal() * MaxSpeed;
+        }
+        else
+        {
+            Result = Preferred;
+        }
+
+        for (int32 i = 0; i < Lines.Num(); ++i)
+        {
+            if (Det(Lines[i].Direction, Lines[i].Point - Result) > 0.0f)
+            {
+                const FVector2f PreviousResult = Result;
+                if (!SolveOnLine(Lines, i, MaxSpeed, Preferred, bDirectionOpt, Result))
+                {
+                    Result = PreviousResult;
+                    return i;
+                }
+            }
+        }
+        return Lines.Num();
+    }
+
+    // Too crowded to satisfy everyone: minimize the worst violation instead
+    void SolveLeastViolating(const FOrcaLines& Lines, int32 BeginLine, float MaxSpeed, FVector2f& Result)
+    {
+        float Distance = 0.0f;
+        for (int32 i = BeginLine; i < Lines.Num(); ++i)
+        {
+            if (Det(Lines[i].Direction, Lines[i].Point - Result) <= Distance)
+            {
+                continue;
+            }
+
+            FOrcaLines Projected;
+            for (int32 j = 0; j < i; ++j)
+            {
+                FOrcaLine Line;
+                const float Determinant = Det(Lines[i].Direction, Lines[j].Direction);
+                if (FMath::Abs(Determinant) <= OrcaEpsilon)
+                {
+                    if ((Lines[i].Direction | Lines[j].Direction) > 0.0f)
+                    {
+                        continue;
+                    }
+                    Line.Point = (Lines[i].Point + Lines[j].Point) * 0.5f;
+                }
+                else
+                {
+                    Line.Point = Lines[i].Point + Lines[i].Direction * (Det(Lines[j].Direction, Lines[i].Point - Lines[j].Point) / Determinant);
+                }
+                Line.Direction = (Lines[j].Direction - Lines[i].Direction).GetSafeNormal();
+                Projected.Add(Line);
+            }
+
+            const FVector2f PreviousResult = Result;
+            if (SolveLines(Projected, MaxSpeed, FVector2f(-Lines[i].Direction.Y, Lines[i].Direction.X), true, Result) < Projected.Num())
+            {
+                // Only fails through rounding; keep what we had
+                Result = PreviousResult;
+            }
+            Distance = Det(Lines[i].Direction, Lines[i].Point - Result);
+        }
+    }
+}
+
+bool UUnitAvoidanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UUnitAvoidanceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitAvoidanceSubsystem, STATGROUP_Tickables);
+}
+
+void UUnitAvoidanceSubsystem::RegisterAgent(UUnitMovementComponent* Agent)
+{
+    if (Agent && !AgentIndices.Contains(Agent))
+    {
+        AgentIndices.Add(Agent, Agents.Add(Agent));
+    }
+}
+
+void UUnitAvoidanceSubsystem::UnregisterAgent(UUnitMovementComponent* Agent)
+{
+    int32 Index = INDEX_NONE;
+    if (!AgentIndices.RemoveAndCopyValue(Agent, Index))
+    {
+        return;
+    }
+
+    Agents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    if (Agents.IsValidIndex(Index))
+    {
+        AgentIndices[Agents[Index]] = Index;
+    }
+}
+
+void UUnitAvoidanceSubsystem::Tick(float DeltaTime)
+{
+    // Units are only moved by the server (or standalone)
+    if (GetWorld()->GetNetMode() == NM_Client || Agents.Num() == 0 || DeltaTime <= 0.0f)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_UnitAvoidance);
+
+    GatherAgents();
+    BuildGrid();
+    SolveAgents(DeltaTime);
+
+    for (int32 i = 0; i < Snapshot.Num(); ++i)
+    {
+        if (bSteered[i])
+        {
+            Snapshot[i]->SetAvoidanceVelocity(FVector(OutVelocityX[i], OutVelocityY[i], 0.0f));
+        }
+    }
+}
+
+void UUnitAvoidanceSubsystem::GatherAgents()
+{
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+    bWrap = ToroidalWorld != nullptr;
+    WorldWidth = bWrap ? ToroidalWorld->WorldWidth : 0.0f;
+    WorldHeight = bWrap ? ToroidalWorld->WorldHeight : 0.0f;
+    WorldCenter = bWrap ? ToroidalWorld->WorldCenter : FVector::ZeroVector;
+
+    Snapshot.Reset();
+    PositionX.Reset();
+    PositionY.Reset();
+    VelocityX.Reset();
+    VelocityY.Reset();
+    PreferredX.Reset();
+    PreferredY.Reset();
+    Radius.Reset();
+    MaxSpeed.Reset();
+    bSteered.Reset();
+
+    for (UUnitMovementComponent* Agent : Agents)
+    {
+        // Pooled units are hidden with movement off; they're not in anyone's way
+        const AActor* Owner = Agent ? Agent->GetOwner() : nullptr;
+        if (!Owner || Owner->IsHidden() || Agent->MovementMode == MOVE_None)
+        {
+            continue;
+        }
+
+        float Unused = 0.0f;
+        float AgentRadius = 0.0f;
+        Owner->GetSimpleCollisionCylinder(AgentRadius, Unused);
+
+        const FVector Location = Agent->GetActorFeetLocation() - WorldCenter;
+        const FVector& Preferred = Agent->GetPreferredVelocity();
+
+        Snapshot.Add(Agent);
+        PositionX.Add(Location.X);
+        PositionY.Add(Location.Y);
+        VelocityX.Add(Agent->Velocity.X);
+        VelocityY.Add(Agent->Velocity.Y);
+        PreferredX.Add(Preferred.X);
+        PreferredY.Add(Preferred.Y);
+        Radius.Add(AgentRadius);
+        MaxSpeed.Add(Agent->GetMaxSpeed());
+        bSteered.Add(Agent->bUseUnitAvoidance && !Preferred.IsNearlyZero());
+    }
+
+    OutVelocityX.SetNumUninitialized(Snapshot.Num());
+    OutVelocityY.SetNumUninitialized(Snapshot.Num());
+}
+
+void UUnitAvoidanceSubsystem::BuildGrid()
+{
+    // On a torus the cells tile the map exactly so they can wrap
+    NumCellsX = bWrap ? FMath::Max(1, FMath::FloorToInt(WorldWidth / NeighbourRadius)) : 0;
+    NumCellsY = bWrap ? FMath::Max(1, FMath::FloorToInt(WorldHeight / NeighbourRadius)) : 0;
+    CellSizeX = bWrap ? WorldWidth / NumCellsX : NeighbourRadius;
+    CellSizeY = bWrap ? WorldHeight / NumCellsY : NeighbourRadius;
+
+    CellHeads.Reset();
+    NextInCell.SetNumUninitialized(Snapshot.Num());
+    for (int32 i = 0; i < Snapshot.Num(); ++i)
+    {
+        int32& Head = CellHeads.FindOrAdd(GetCell(PositionX[i], PositionY[i]), INDEX_NONE);
+        NextInCell[i] = Head;
+        Head = i;
+    }
+}
+
+FIntPoint UUnitAvoidanceSubsystem::GetCell(float X, float Y) const
+{
+    if (!bWrap)
+    {
+        return FIntPoint(FMath::FloorToInt(X / CellSizeX), FMath::FloorToInt(Y / CellSizeY));
+    }
+
+    // Shift from [-Half, Half) into [0, Size)
+    const int32 CellX = FMath::FloorToInt((FToroidalMath::Wrap(X, WorldWidth) + WorldWidth * 0.5f) / CellSizeX);
+    const int32 CellY = FMath::FloorToInt((FToroidalMath::Wrap(Y, WorldHeight) + WorldHeight * 0.5f) / CellSizeY);
+    return FIntPoint(FMath::Clamp(CellX, 0, NumCellsX - 1), FMath::Clamp(CellY, 0, NumCellsY - 1));
+}
+
+void UUnitAvoidanceSubsystem::SolveAgents(float DeltaTime)
+{
+    const int32 NumAgents = Snapshot.Num();
+    const float InvTimeHorizon = 1.0f / TimeHorizon;
+    const float InvDeltaTime = 1.0f / DeltaTime;
+    const float NeighbourRadiusSquared = FMath::Square(NeighbourRadius);
+
+    // On a small torus the 3x3 block must not visit a column twice
+    const int32 SpanX = bWrap ? FMath::Min(3, NumCellsX) : 3;
+    const int32 SpanY = bWrap ? FMath::Min(3, NumCellsY) : 3;
+
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumAgents, SolveChunkSize);
+    ParallelFor(TEXT("UnitAvoidance"), NumChunks, 1, [&](int32 ChunkIndex)
+    {
+        const int32 First = ChunkIndex * SolveChunkSize;
+        const int32 Last = FMath::Min(First + SolveChunkSize, NumAgents);
+
+        // Nearest neighbours, closest first: (distance squared, index)
+        TArray<TPair<float, int32>, TInlineAllocator<32>> Neighbours;
+        FOrcaLines Lines;
+
+        for (int32 i = First; i < Last; ++i)
+        {
+            if (!bSteered[i])
+            {
+                continue;
+            }
+
+            Neighbours.Reset();
+            const FIntPoint Cell = GetCell(PositionX[i], PositionY[i]);
+            for (int32 OffsetY = 0; OffsetY < SpanY; ++OffsetY)
+            {
+                for (int32 OffsetX = 0; OffsetX < SpanX; ++OffsetX)
+                {
+                    FIntPoint Visit(Cell.X - 1 + OffsetX, Cell.Y - 1 + OffsetY);
+                    if (bWrap)
+                    {
+                        Visit.X = (Visit.X + NumCellsX) % NumCellsX;
+                        Visit.Y = (Visit.Y + NumCellsY) % NumCellsY;
+                    }
+
+                    const int32* Head = CellHeads.Find(Visit);
+                    for (int32 j = Head ? *Head : INDEX_NONE; j != INDEX_NONE; j = NextInCell[j])
+                    {
+                        if (j == i)
+                        {
+                            continue;
+                        }
+
+                        float DX = PositionX[j] - PositionX[i];
+                        float DY = PositionY[j] - PositionY[i];
+                        if (bWrap)
+                        {
+                            DX = FToroidalMath::Wrap(DX, WorldWidth);
+                            DY = FToroidalMath::Wrap(DY, WorldHeight);
+                        }
+
+                        const float DistanceSquared = DX * DX + DY * DY;
+                        if (DistanceSquared >= NeighbourRadiusSquared)
+                        {
+                            continue;
+                        }
+
+                        if (Neighbours.Num() == MaxNeighbours)
+                        {
+                            if (DistanceSquared >= Neighbours.Last().Key)
+                            {
+                                continue;
+                            }
+                            Neighbours.Pop(EAllowShrinking::No);
+                        }
+
+                        int32 Insert = Neighbours.Num();
+                        while (Insert > 0 && Neighbours[Insert - 1].Key > DistanceSquared)
+                        {
+                            --Insert;
+                        }
+                        Neighbours.Insert(TPair<float, int32>(DistanceSquared, j), Insert);
+                    }
+                }
+            }
+
+            // One half-plane of allowed velocities per neighbour
+            const FVector2f Velocity(VelocityX[i], VelocityY[i]);
+            Lines.Reset();
+            for (const TPair<float, int32>& Neighbour : Neighbours)
+            {
+                const int32 j = Neighbour.Value;
+
+                FVector2f RelativePosition(PositionX[j] - PositionX[i], PositionY[j] - PositionY[i]);
+                if (bWrap)
+                {
+                    RelativePosition.X = FToroidalMath::Wrap(RelativePosition.X, WorldWidth);
+                    RelativePosition.Y = FToroidalMath::Wrap(RelativePosition.Y, WorldHeight);
+                }
+                const FVector2f RelativeVelocity = Velocity - FVector2f(VelocityX[j], VelocityY[j]);
+                const float DistanceSquared = Neighbour.Key;
+                const float CombinedRadius = Radius[i] + Radius[j];
+                const float CombinedRadiusSquared = FMath::Square(CombinedRadius);
+
+                FOrcaLine Line;
+                FVector2f U;
+                if (DistanceSquared > CombinedRadiusSquared)
+                {
+                    // No overlap yet: velocity obstacle is a cone truncated at the time horizon
+                    const FVector2f W = RelativeVelocity - RelativePosition * InvTimeHorizon;
+                    const float WLengthSquared = W.SizeSquared();
+                    const float DotProduct = W | RelativePosition;
+
+                    if (DotProduct < 0.0f && FMath::Square(DotProduct) > CombinedRadiusSquared * WLengthSquared)
+                    {
+                        // Closest to the cut-off circle
+                        const float WLength = FMath::Sqrt(WLengthSquared);
+                        const FVector2f UnitW = W / WLength;
+                        Line.Direction = FVector2f(UnitW.Y, -UnitW.X);
+                        U = UnitW * (CombinedRadius * InvTimeHorizon - WLength);
+                    }
+                    else
+                    {
+                        // Closest to one of the cone's legs
+                        const float Leg = FMath::Sqrt(DistanceSquared - CombinedRadiusSquared);
+                        if (Det(RelativePosition, W) > 0.0f)
+                        {
+                            Line.Direction = FVector2f(RelativePosition.X * Leg - RelativePosition.Y * CombinedRadius,
+                                                       RelativePosition.X * CombinedRadius + RelativePosition.Y * Leg) / DistanceSquared;
+                        }
+                        else
+                        {
+                            Line.Direction = -FVector2f(RelativePosition.X * Leg + RelativePosition.Y * CombinedRadius,
+                                                        -RelativePosition.X * CombinedRadius + RelativePosition.Y * Leg) / DistanceSquared;
+                        }
+                        U = Line.Direction * (RelativeVelocity | Line.Direction) - RelativeVelocity;
+                    }
+                }
+                else
+                {
+                    // Already overlapping: get apart within this step
+                    const FVector2f W = RelativeVelocity - RelativePosition * InvDeltaTime;
+                    const float WLength = W.Size();
+                    const FVector2f UnitW = WLength > OrcaEpsilon ? W / WLength : FVector2f(1.0f, 0.0f);
+                    Line.Direction = FVector2f(UnitW.Y, -UnitW.X);
+                    U = UnitW * (CombinedRadius * InvDeltaTime - WLength);
+                }
+
+                // Moving neighbours take half the correction, idle ones none
+                const float Responsibility = bSteered[j] ? 0.5f : 1.0f;
+                Line.Point = Velocity + U * Responsibility;
+                Lines.Add(Line);
+            }
+
+            const FVector2f Preferred(PreferredX[i], PreferredY[i]);
+            FVector2f Result;
+            const int32 LineFail = SolveLines(Lines, MaxSpeed[i], Preferred, false, Result);
+            if (LineFail < Lines.Num())
+            {
+                SolveLeastViolating(Lines, LineFail, MaxSpeed[i], Result);
+            }
+
+            OutVelocityX[i] = Result.X;
+            OutVelocityY[i] = Result.Y;
+        }
+    });
+}
@@ -1,6 +1,14 @@
 #include "UnitBase.h"
 #include "UnitController.h"
 #include "UnitSelectionManager.h"
+#include "UnitTickSubsystem.h"
+#include "UnitAssetCache.h"
+#include "UnitMovementComponent.h"
+#include "UnitSkeletalMeshComponent.h"
+#include "CustomPlayerState.h"
+#include "UnitLockstepSubsystem.h"
+#include "Toroid.h"
+#include "Net/UnrealNetwork.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SkeletalMeshComponent.h"
@@ -9,9 +17,13 @@
 #include "Engine/Engine.h"
 
 // Sets default values
-AUnitBase::AUnitBase()
+AUnitBase::AUnitBase(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer
+                .SetDefaultSubobjectClass<UUnitMovementComponent>(ACharacter::CharacterMovementComponentName)
+                .SetDefaultSubobjectClass<UUnitSkeletalMeshComponent>(ACharacter::MeshComponentName))
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Ticked centrally by UUnitTickSubsystem, and only while active
+    PrimaryActorTick.bCanEverTick = false;
 
     // Initialize defaults
     TeamId = 0;
@@ -74,6 +86,46 @@ void AUnitBase::BeginPlay()
     LoadSelectionMesh();
 
     UpdateSelectionVisual();
+
+    if (UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>())
+    {
+        UnitTick->RegisterUnit(this);
+    }
+
+    // Every unit joins here, whether placed in the level, spawned by Blueprint or by the pool
+    UpdateRoster();
+}
+
+void AUnitBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>())
+    {
+        UnitTick->UnregisterUnit(this);
+    }
+
+    LeaveRoster();
+
+    if (UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>())
+    {
+        Lockstep->DetachActor(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AUnitBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(AUnitBase, LockstepId);
+}
+
+void AUnitBase::OnRep_LockstepId()
+{
+    if (UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>())
+    {
+        Lockstep->AttachActor(this, LockstepId);
+    }
 }
 
 void AUnitBase::SetupCollision()
@@ -86,7 +138,8 @@ void AUnitBase::SetupCollision()
         CapsuleComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
         CapsuleComp->SetCollisionObjectType(ECC_Pawn);
         CapsuleComp->SetCollisionResponseToAllChannels(ECR_Block);
-        CapsuleComp->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block);
+        // Units keep apart through UUnitAvoidanceSubsystem, not physics contacts
+        CapsuleComp->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
         CapsuleComp->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
         
     }
@@ -98,6 +151,10 @@ void AUnitBase::SetupCollision()
         // Move mesh down so feet are at capsule bottom
         MeshComp->SetRelativeLocation(FVector(0.0f, 0.0f, -88.0f));
         MeshComp->SetRelativeRotation(FRotator(0.0f, -90.0f, 0.0f)); // Adjust if needed
+
+        // Off-screen units don't animate; on-screen rates come from UUnitAnimationBudgetSubsystem
+        MeshComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+        MeshComp->bEnableUpdateRateOptimizations = true;
     }
 }
 
@@ -131,15 +188,15 @@ void AUnitBase::LoadUnitMesh()
 {
     if (UnitMesh.IsValid() || UnitMesh.ToSoftObjectPath().IsValid())
     {
-        FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
-        Streamable.RequestAsyncLoad(UnitMesh.ToSoftObjectPath(),
+        UUnitAssetCache::Load(this, UnitMesh.ToSoftObjectPath(), FSimpleDelegate::CreateWeakLambda(this,
             [this]()
             {
                 if (UnitMesh.IsValid() && GetMesh())
                 {
                     GetMesh()->SetSkeletalMesh(UnitMesh.Get());
+                    MarkWrappedImagesDirty();
                 }
-            });
+            }));
     }
 }
 
@@ -147,22 +204,42 @@ void AUnitBase::LoadSelectionMesh()
 {
     if (SelectionMesh.IsValid() || SelectionMesh.ToSoftObjectPath().IsValid())
     {
-        FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
-        Streamable.RequestAsyncLoad(SelectionMesh.ToSoftObjectPath(),
+        UUnitAssetCache::Load(this, SelectionMesh.ToSoftObjectPath(), FSimpleDelegate::CreateWeakLambda(this,
             [this]()
             {
                 if (SelectionMesh.IsValid() && SelectionIndicator)
                 {
                     SelectionIndicator->SetStaticMesh(SelectionMesh.Get());
+                    MarkWrappedImagesDirty();
                 }
-            });
+            }));
     }
 }
 
-void AUnitBase::Tick(float DeltaTime)
+void AUnitBase::MarkWrappedImagesDirty()
 {
-    Super::Tick(DeltaTime);
-    UpdateAnimationState();
+    // Mesh proxies across the world edge copy the new mesh on their next update
+    if (UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this))
+    {
+        ToroidalWorld->MarkActorDirty(this);
+    }
+}
+
+void AUnitBase::GetAssetsToPreload(TArray<FSoftObjectPath>& OutPaths) const
+{
+    OutPaths.AddUnique(UnitMesh.ToSoftObjectPath());
+    OutPaths.AddUnique(SelectionMesh.ToSoftObjectPath());
+
+    // Crowd visuals, both sexes
+    for (const EUnitSex Sex : { EUnitSex::Male, EUnitSex::Female })
+    {
+        if (const FUnitCrowdVisual* Visual = GetCrowdVisual(Sex))
+        {
+            OutPaths.AddUnique(Visual->Mesh.ToSoftObjectPath());
+        }
+    }
+
+    OutPaths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
 }
 
 void AUnitBase::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -190,6 +267,15 @@ void AUnitBase::SetIsMoving(bool bMoving)
         bShouldMove = bMoving;
         UpdateAnimationState();
 
+        // Stopping is picked up by the tick once the unit has slowed down
+        if (bMoving)
+        {
+            if (UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>())
+            {
+                UnitTick->ActivateUnit(this);
+            }
+        }
+
         UE_LOG(LogTemp, VeryVerbose, TEXT("Unit %s movement state changed to: %s"),
             *GetName(), bMoving ? TEXT("Moving") : TEXT("Idle"));
     }
@@ -200,9 +286,122 @@ void AUnitBase::InitializeUnit(int32 InTeamId, AUnitSelectionManager* InSelectio
     TeamId = InTeamId;
     SelectionManager = InSelectionManager;
 
+    UpdateRoster();
+
     UE_LOG(LogTemp, Log, TEXT("Unit %s initialized with TeamId: %d"), *GetName(), TeamId);
 }
 
+void AUnitBase::ResetForPool()
+{
+    if (SelectionManager)
+    {
+        SelectionManager->DeselectUnit(this);
+    }
+    SetIsSelected(false);
+
+    // Keep the controller possessed, just idle
+    if (AUnitController* UnitController = Cast<AUnitController>(GetController()))
+    {
+        UnitController->StopMovement();
+    }
+    SetIsMoving(false);
+
+    if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+    {
+        MovementComp->StopMovementImmediately();
+        MovementComp->DisableMovement();
+    }
+
+    SetActorHiddenInGame(true);
+    SetActorEnableCollision(false);
+
+    if (UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>())
+    {
+        UnitTick->UnregisterUnit(this);
+    }
+
+    LeaveRoster();
+
+    // Out of the lockstep session; reacquired, it joins with a new id
+    if (UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>())
+    {
+        Lockstep->DetachActor(this);
+    }
+
+    SelectionManager = nullptr;
+    CrowdUnitId = INDEX_NONE;
+    bIsPooled = true;
+}
+
+void AUnitBase::SetTeamId(int32 NewTeamId)
+{
+    TeamId = NewTeamId;
+
+    // Before BeginPlay the unit isn't listed anywhere yet
+    if (HasActorBegunPlay())
+    {
+        UpdateRoster();
+    }
+}
+
+void AUnitBase::UpdateRoster()
+{
+    if (!HasAuthority() || bIsPooled || IsActorBeingDestroyed())
+    {
+        return;
+    }
+
+    // A team without a player state yet is picked up when one joins
+    ACustomPlayerState* Owner = ACustomPlayerState::FindForTeam(this, TeamId);
+    if (Owner != RosterOwner.Get())
+    {
+        LeaveRoster();
+        if (Owner)
+        {
+            Owner->RegisterUnit(this);
+            RosterOwner = Owner;
+        }
+    }
+}
+
+void AUnitBase::LeaveRoster()
+{
+    if (ACustomPlayerState* Owner = RosterOwner.Get())
+    {
+        Owner->UnregisterUnit(this);
+    }
+    RosterOwner = nullptr;
+}
+
+void AUnitBase::ReinitializeFromPool(const FTransform& Transform, int32 InTeamId, EUnitSex InSex, AUnitSelectionManager* InSelectionManager)
+{
+    bIsPooled = false;
+
+    SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(true);
+
+    if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+    {
+        MovementComp->SetMovementMode(MOVE_Walking);
+        MovementComp->MaxWalkSpeed = UnitMovementSpeed;
+    }
+
+    InitializeUnit(InTeamId, InSelectionManager);
+    SetUnitSex(InSex);
+    UpdateSelectionVisual();
+
+    if (UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>())
+    {
+        UnitTick->RegisterUnit(this);
+    }
+
+    if (!GetController())
+    {
+        SpawnDefaultController();
+    }
+}
+
 void AUnitBase::UpdateSelectionVisual()
 {
     if (SelectionIndicator)
@@ -236,13 +435,7 @@ void AUnitBase::UpdateAnimationState()
         float MovementThreshold = 10.0f;
         bShouldMove = MovementSpeed > MovementThreshold && bIsMoving;
         
-        // FORCE ANIMATION UPDATE - Add this temporarily
-        USkeletalMeshComponent* MeshComp = GetMesh();
-        if (MeshComp && MeshComp->GetAnimInstance())
-        {
-            // Force the animation instance to refresh
-            MeshComp->GetAnimInstance()->UpdateAnimation(GetWorld()->GetDeltaSeconds(), false);
-        }
+        // The anim instance reads these on its own update, paced by UUnitAnimationBudgetSubsystem
         /*
         UE_LOG(LogTemp, Warning, TEXT("Unit %s: Speed=%.2f, bIsMoving=%s, bShouldMove=%s"),
             *GetName(), 
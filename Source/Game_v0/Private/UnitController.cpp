@@ -1,6 +1,9 @@
 #include "UnitController.h"
 #include "UnitBase.h"
-#include "UnitCommand.h"
+#include "UnitFlowField.h"
+#include "UnitPathRequestSubsystem.h"
+#include "Toroid.h"
+#include "NavigationSystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "AIController.h"
@@ -9,11 +12,14 @@
 
 AUnitController::AUnitController()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Movement is driven by UUnitTickSubsystem; path following ticks on its own
+    PrimaryActorTick.bCanEverTick = false;
     bHasDestination = false;
     bIsMoving = false;
     CurrentDestination = FVector::ZeroVector;
-    AcceptanceRadius = 4.0f;
+    SeamEntryLocation = FVector::ZeroVector;
+    // Units in a formation jostle; a few centimetres is never reached
+    AcceptanceRadius = 50.0f;
     
     // Enable AI for this controller
     bWantsPlayerState = false;
@@ -35,10 +41,16 @@ void AUnitController::BeginPlay()
 
 }
 
-void AUnitController::Tick(float DeltaTime)
+void AUnitController::OnPossess(APawn* InPawn)
+{
+    Super::OnPossess(InPawn);
+
+    // Units spawned at runtime are possessed after our BeginPlay
+    ControlledUnit = Cast<AUnitBase>(InPawn);
+}
+
+void AUnitController::TickMovement(float DeltaTime)
 {
-    Super::Tick(DeltaTime);
-    
     if (bHasDestination && ControlledUnit)
     {
         UpdateMovement(DeltaTime);
@@ -59,20 +71,155 @@ void AUnitController::MoveToLocation(FVector Destination)
     
     // Disable direct movement, enable pathfinding
     bUseDirectMovement = false;
+    bCrossingSeam = false;
+    FlowField.Reset();
+
+    // On a toroidal map the goal may be closer across a seam. The navmesh
+    // doesn't know that, so walk to the seam first and hand off from there.
+    FVector LegGoal = Destination;
+    if (UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this))
+    {
+        FVector SeamExit;
+        if (ToroidalWorld->GetSeamCrossing(ControlledUnit->GetActorLocation(), Destination, SeamHandoffInset, SeamExit, SeamEntryLocation))
+        {
+            LegGoal = SeamExit;
+            bCrossingSeam = true;
+        }
+    }
+
+    RequestPathTo(LegGoal);
+
+    // Trigger walking animation
+    ControlledUnit->SetIsMoving(true);
+
+    UE_LOG(LogTemp, Log, TEXT("UnitController: Requested path to location %s%s"), *CurrentDestination.ToString(),
+           bCrossingSeam ? TEXT(" across seam") : TEXT(""));
+}
+
+void AUnitController::FollowFlowField(TSharedPtr<const FUnitFlowField> Field, const FVector& Destination)
+{
+    if (!ControlledUnit || !Field.IsValid())
+    {
+        ExecuteCommand(FUnitCommand(EUnitCommandType::Move, Destination));
+        return;
+    }
+
+    // Drop any path we were following; the field replaces it. Its abort
+    // clears the orders, so the Move is set after.
+    Super::StopMovement();
+    ClearCommandQueue();
+    CurrentCommand = FUnitCommand(EUnitCommandType::Move, Destination);
+
+    CurrentDestination = Destination;
+    bHasDestination = true;
+    bIsMoving = true;
+    bUseDirectMovement = false;
+    bCrossingSeam = false;
+    PendingPathRequestId = 0;
+    FlowField = MoveTemp(Field);
+
+    ControlledUnit->SetIsMoving(true);
+
+    UE_LOG(LogTemp, Verbose, TEXT("UnitController: Following flow field to %s"), *CurrentDestination.ToString());
+}
+
+void AUnitController::RequestPathTo(const FVector& Goal)
+{
+    // Queued and solved off the game thread; we start walking in OnPathRequestFinished
+    if (UUnitPathRequestSubsystem* PathRequests = GetWorld()->GetSubsystem<UUnitPathRequestSubsystem>())
+    {
+        // The old path must not finish while the new one is queued: its
+        // completion would end or hand off the new order
+        {
+            TGuardValue<bool> AbortGuard(bAbortingOwnMove, true);
+            Super::StopMovement();
+        }
+
+        PendingPathRequestId = PathRequests->RequestPath(this, GetNavAgentLocation(), Goal);
+        return;
+    }
 
     // Call AIController’s built-in pathfinding
     FAIMoveRequest MoveRequest;
-    MoveRequest.SetGoalLocation(Destination);
+    MoveRequest.SetGoalLocation(Goal);
     MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
     MoveRequest.SetUsePathfinding(true);
 
     FNavPathSharedPtr NavPath;
-    MoveTo(MoveRequest, &NavPath);
+    const FPathFollowingRequestResult Result = MoveTo(MoveRequest, &NavPath);
 
-    // Trigger walking animation
-    ControlledUnit->SetIsMoving(true);
+    // Seam unreachable from here - fall back to the long way round
+    if (bCrossingSeam && Result.Code == EPathFollowingRequestResult::Failed)
+    {
+        bCrossingSeam = false;
+        MoveRequest.SetGoalLocation(CurrentDestination);
+        MoveTo(MoveRequest, &NavPath);
+    }
+}
+
+void AUnitController::OnPathRequestFinished(uint32 RequestId, FNavPathSharedPtr Path)
+{
+    // Superseded by a newer order, or the order was cancelled
+    if (RequestId != PendingPathRequestId)
+    {
+        return;
+    }
+    PendingPathRequestId = 0;
+
+    if (!ControlledUnit || !bHasDestination)
+    {
+        return;
+    }
+
+    if (!Path.IsValid())
+    {
+        // Seam unreachable from here - fall back to the long way round
+        if (bCrossingSeam)
+        {
+            bCrossingSeam = false;
+            RequestPathTo(CurrentDestination);
+            return;
+        }
+
+        StopMovement();
+        UE_LOG(LogTemp, Warning, TEXT("UnitController: No path to %s"), *CurrentDestination.ToString());
+        return;
+    }
+
+    FAIMoveRequest MoveRequest;
+    MoveRequest.SetGoalLocation(Path->GetPathPoints().Last().Location);
+    MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
+    MoveRequest.SetUsePathfinding(true);
 
-    UE_LOG(LogTemp, Log, TEXT("UnitController: Pathfinding to location %s"), *CurrentDestination.ToString());
+    RequestMove(MoveRequest, Path);
+}
+
+void AUnitController::HandOffAcrossSeam()
+{
+    bCrossingSeam = false;
+    TeleportAcrossSeam(SeamEntryLocation);
+
+    // Plan the rest from the far side (a corner route crosses a second seam)
+    MoveToLocation(CurrentDestination);
+}
+
+void AUnitController::TeleportAcrossSeam(const FVector& Entry)
+{
+    // Keep the unit's height and snap onto the navmesh on the far side
+    FVector EntryLocation(Entry.X, Entry.Y, ControlledUnit->GetActorLocation().Z);
+    if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+    {
+        FNavLocation NavLocation;
+        if (NavSys->ProjectPointToNavigation(EntryLocation, NavLocation))
+        {
+            EntryLocation.X = NavLocation.Location.X;
+            EntryLocation.Y = NavLocation.Location.Y;
+        }
+    }
+
+    ControlledUnit->SetActorLocation(EntryLocation, false, nullptr, ETeleportType::TeleportPhysics);
+
+    UE_LOG(LogTemp, Log, TEXT("UnitController: Crossed seam to %s"), *EntryLocation.ToString());
 }
 
 void AUnitController::StopMovement()
@@ -82,6 +229,10 @@ void AUnitController::StopMovement()
     bHasDestination = false;
     bIsMoving = false;
     bUseDirectMovement = false;
+    bCrossingSeam = false;
+    FlowField.Reset();
+    PendingPathRequestId = 0;
+    ClearCommandQueue();
     
     if (ControlledUnit)
     {
@@ -92,12 +243,79 @@ void AUnitController::StopMovement()
 }
 
 void AUnitController::ExecuteCommand(const FUnitCommand& Command)
+{
+    // A more important order keeps going; this one waits its turn
+    if (CurrentCommand.IsValid() && Command.Priority < CurrentCommand.Priority)
+    {
+        QueueCommand(Command);
+        return;
+    }
+
+    ClearCommandQueue();
+
+    StartPatrolOrCommand(Command);
+}
+
+void AUnitController::QueueCommand(const FUnitCommand& Command)
+{
+    if (!CurrentCommand.IsValid())
+    {
+        StartPatrolOrCommand(Command);
+        return;
+    }
+
+    if (Command.Priority > CurrentCommand.Priority)
+    {
+        // Interrupt; pick the current order up again once this one is done
+        PushCommandFront(CurrentCommand);
+        StartCommand(Command);
+        return;
+    }
+
+    if (!PushCommandBack(Command))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("UnitController: Command queue full, dropped %s"), *Command.ToString());
+    }
+}
+
+void AUnitController::ClearCommandQueue()
+{
+    CurrentCommand = FUnitCommand();
+    QueueHead = 0;
+    NumQueuedCommands = 0;
+}
+
+void AUnitController::StartPatrolOrCommand(const FUnitCommand& Command)
+{
+    // A patrol started from rest walks between here and the target
+    if (Command.CommandType == EUnitCommandType::Patrol && ControlledUnit)
+    {
+        FUnitCommand ReturnLeg = Command;
+        ReturnLeg.TargetLocation = ControlledUnit->GetActorLocation();
+        ReturnLeg.TargetActor = nullptr;
+        PushCommandBack(ReturnLeg);
+    }
+
+    StartCommand(Command);
+}
+
+void AUnitController::StartCommand(const FUnitCommand& Command)
 {
     switch (Command.CommandType)
     {
         case EUnitCommandType::Move:
+        case EUnitCommandType::Patrol:
+            CurrentCommand = Command;
             MoveToLocation(Command.TargetLocation);
             break;
+        case EUnitCommandType::Attack:
+        {
+            // No combat yet: close in on the target
+            CurrentCommand = Command;
+            const AActor* Target = Command.TargetActor.Get();
+            MoveToLocation(Target ? Target->GetActorLocation() : Command.TargetLocation);
+            break;
+        }
         case EUnitCommandType::Stop:
             StopMovement();
             break;
@@ -107,6 +325,66 @@ void AUnitController::ExecuteCommand(const FUnitCommand& Command)
     }
 }
 
+void AUnitController::AdvanceCommandQueue()
+{
+    const FUnitCommand Finished = CurrentCommand;
+    CurrentCommand = FUnitCommand();
+
+    // Patrol waypoints go round again, as long as there is another stop to
+    // go to; a lone waypoint would be "reached" again every frame
+    if (Finished.CommandType == EUnitCommandType::Patrol && NumQueuedCommands > 0)
+    {
+        PushCommandBack(Finished);
+    }
+
+    FUnitCommand Next;
+    if (PopCommand(Next))
+    {
+        StartCommand(Next);
+    }
+}
+
+bool AUnitController::PushCommandBack(const FUnitCommand& Command)
+{
+    if (NumQueuedCommands == MaxQueuedCommands)
+    {
+        return false;
+    }
+
+    QueuedCommands[(QueueHead + NumQueuedCommands) % MaxQueuedCommands] = Command;
+    NumQueuedCommands++;
+    return true;
+}
+
+void AUnitController::PushCommandFront(const FUnitCommand& Command)
+{
+    // Whatever runs next matters more than the last thing queued; make room
+    if (NumQueuedCommands == MaxQueuedCommands)
+    {
+        const FUnitCommand& Evicted = QueuedCommands[(QueueHead + NumQueuedCommands - 1) % MaxQueuedCommands];
+        UE_LOG(LogTemp, Warning, TEXT("UnitController: Command queue full, dropped %s"), *Evicted.ToString());
+        NumQueuedCommands--;
+    }
+
+    QueueHead = (QueueHead + MaxQueuedCommands - 1) % MaxQueuedCommands;
+    QueuedCommands[QueueHead] = Command;
+    NumQueuedCommands++;
+}
+
+bool AUnitController::PopCommand(FUnitCommand& OutCommand)
+{
+    if (NumQueuedCommands == 0)
+    {
+        return false;
+    }
+
+    OutCommand = QueuedCommands[QueueHead];
+    QueuedCommands[QueueHead] = FUnitCommand();
+    QueueHead = (QueueHead + 1) % MaxQueuedCommands;
+    NumQueuedCommands--;
+    return true;
+}
+
 void AUnitController::UpdateMovement(float DeltaTime)
 {
     if (!ControlledUnit || !bHasDestination)
@@ -115,15 +393,19 @@ void AUnitController::UpdateMovement(float DeltaTime)
     FVector CurrentLocation = ControlledUnit->GetActorLocation();
     float DistanceToDestination = FVector::Dist2D(CurrentLocation, CurrentDestination);
 
-    // Check if we've reached the destination
-    if (DistanceToDestination <= AcceptanceRadius)
+    // Check if we've reached the destination; not while the path for it is
+    // still being solved, since arriving would drop the pending order
+    if (DistanceToDestination <= AcceptanceRadius && PendingPathRequestId == 0)
     {
         OnReachedDestination();
         return;
     }
     
-    // If using direct movement
-    if (bUseDirectMovement)
+    if (FlowField.IsValid())
+    {
+        MoveAlongFlowField(DeltaTime);
+    }
+    else if (bUseDirectMovement)
     {
         MoveDirectly(DeltaTime);
     }
@@ -140,6 +422,50 @@ void AUnitController::MoveDirectly(float DeltaTime)
     FVector CurrentLocation = ControlledUnit->GetActorLocation();
     FVector Direction = (CurrentDestination - CurrentLocation).GetSafeNormal();
     
+    SteerTowards(Direction, DeltaTime);
+    
+    UE_LOG(LogTemp, VeryVerbose, TEXT("Direct movement: Current %s, Target %s, Direction %s"), 
+           *CurrentLocation.ToString(), *CurrentDestination.ToString(), *Direction.ToString());
+}
+
+void AUnitController::MoveAlongFlowField(float DeltaTime)
+{
+    const FVector CurrentLocation = ControlledUnit->GetActorLocation();
+
+    // Close enough to the group goal: path to our own slot like any other
+    // move, so the last stretch still goes round buildings and other units
+    if (FlowField->IsInGoalRegion(CurrentLocation))
+    {
+        MoveToLocation(CurrentDestination);
+        return;
+    }
+
+    FVector Direction;
+    if (!FlowField->SampleDirection(CurrentLocation, Direction))
+    {
+        // Pushed off the field or cut off from the goal - path there on our own
+        UE_LOG(LogTemp, Verbose, TEXT("UnitController: Left flow field, pathfinding instead"));
+        MoveToLocation(CurrentDestination);
+        return;
+    }
+
+    // The field routes across seams; hand off once the next step would leave the map
+    if (const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this))
+    {
+        const FVector Probe = CurrentLocation + Direction * (2.0f * SeamHandoffInset);
+        const FVector WrappedProbe = ToroidalWorld->ToroidalToWorld(ToroidalWorld->NormalizeToroidalCoordinate(ToroidalWorld->WorldToToroidal(Probe)));
+        if (!FVector::PointsAreNear(FVector(Probe.X, Probe.Y, 0.0f), FVector(WrappedProbe.X, WrappedProbe.Y, 0.0f), 1.0f))
+        {
+            TeleportAcrossSeam(WrappedProbe);
+            return;
+        }
+    }
+
+    SteerTowards(Direction, DeltaTime);
+}
+
+void AUnitController::SteerTowards(const FVector& Direction, float DeltaTime)
+{
     // Get movement component and use AddMovementInput for proper animation
     UCharacterMovementComponent* MovementComp = ControlledUnit->GetCharacterMovement();
     if (MovementComp)
@@ -157,9 +483,6 @@ void AUnitController::MoveDirectly(float DeltaTime)
         FRotator NewRotation = FMath::RInterpTo(CurrentRotation, TargetRotation, DeltaTime, RotationSpeed / 90.0f);
         ControlledUnit->SetActorRotation(NewRotation);
     }
-    
-    UE_LOG(LogTemp, VeryVerbose, TEXT("Direct movement: Current %s, Target %s, Direction %s"), 
-           *CurrentLocation.ToString(), *CurrentDestination.ToString(), *Direction.ToString());
 }
 
 void AUnitController::OnReachedDestination()
@@ -167,6 +490,8 @@ void AUnitController::OnReachedDestination()
     bHasDestination = false;
     bIsMoving = false;
     bUseDirectMovement = false;
+    FlowField.Reset();
+    PendingPathRequestId = 0;
     
     if (ControlledUnit)
     {
@@ -174,6 +499,9 @@ void AUnitController::OnReachedDestination()
     }
     
     UE_LOG(LogTemp, Log, TEXT("UnitController: Unit reached destination"));
+
+    // Next shift-queued order, if any
+    AdvanceCommandQueue();
 }
 
 
@@ -181,7 +509,18 @@ void AUnitController::OnReachedDestination()
     {
         Super::OnMoveCompleted(RequestID, Result);
 
-        if (Result.IsSuccess())
+        // Replaced by the path of a newer order, which is already set up or
+        // still being solved
+        if (Result.HasFlag(FPathFollowingResultFlags::NewRequest) || bAbortingOwnMove || PendingPathRequestId != 0)
+        {
+            return;
+        }
+
+        if (Result.IsSuccess() && bCrossingSeam && ControlledUnit)
+        {
+            HandOffAcrossSeam();
+        }
+        else if (Result.IsSuccess())
         {
             OnReachedDestination();
         }
@@ -0,0 +1,270 @@
+#include "UnitCrowdRenderSubsystem.h"
+#include "UnitBase.h"
+#include "UnitTickSubsystem.h"
+#include "UnitCrowdSubsystem.h"
+#include "UnitAssetCache.h"
+#include "Toroid.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Unit Crowd Rendering"), STAT_UnitCrowdRender, STATGROUP_Game);
+
+namespace
+{
+    constexpr int32 NumCustomDataFloats = 4;
+
+    // Slower than this plays the idle clip
+    constexpr float WalkSpeedThreshold = 10.0f;
+
+    // Units switch back to skeletal a bit closer than they left it, so they don't flicker on the line
+    constexpr float SkeletalHysteresis = 0.9f;
+}
+
+bool UUnitCrowdRenderSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUnitCrowdRenderSubsystem::Deinitialize()
+{
+    if (HostActor)
+    {
+        HostActor->Destroy();
+        HostActor = nullptr;
+    }
+    Components.Empty();
+    Batches.Empty();
+
+    Super::Deinitialize();
+}
+
+TStatId UUnitCrowdRenderSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitCrowdRenderSubsystem, STATGROUP_Tickables);
+}
+
+void UUnitCrowdRenderSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_UnitCrowdRender);
+
+    const APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    if (!PC || !PC->IsLocalController())
+    {
+        return;
+    }
+
+    FVector ViewLocation;
+    FRotator ViewRotation;
+    PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+    // On a torus a unit is seen wherever its image nearest the camera is:
+    // measure to that image and draw the instance there
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+    const auto NearestImage = [ToroidalWorld, &ViewLocation](const FVector& Location)
+    {
+        return ToroidalWorld ? ViewLocation + ToroidalWorld->GetToroidalDelta(ViewLocation, Location) : Location;
+    };
+
+    for (TPair<UStaticMesh*, FCrowdInstanceBatch>& Pair : Batches)
+    {
+        Pair.Value.Transforms.Reset();
+        Pair.Value.CustomData.Reset();
+    }
+
+    // Actors: far ones swap their skeletal mesh for an instance
+    if (const UUnitTickSubsystem* UnitTick = GetWorld()->GetSubsystem<UUnitTickSubsystem>())
+    {
+        for (AUnitBase* Unit : UnitTick->GetRegisteredUnits())
+        {
+            USkeletalMeshComponent* MeshComp = Unit->GetMesh();
+            const FUnitCrowdVisual* Visual = Unit->GetCrowdVisual(Unit->GetUnitSex());
+            if (!MeshComp || !Visual)
+            {
+                continue;
+            }
+
+            const FVector ActorLocation = Unit->GetActorLocation();
+            const FVector ImageLocation = NearestImage(ActorLocation);
+            FTransform ImageTransform = MeshComp->GetComponentTransform();
+            ImageTransform.AddToTranslation(ImageLocation - ActorLocation);
+
+            const float SwitchDistance = MeshComp->IsVisible() ? SkeletalDistance : SkeletalDistance * SkeletalHysteresis;
+            const bool bInstanced = FVector::Dist(ViewLocation, ImageLocation) > SwitchDistance &&
+                                    AddInstance(*Visual, ImageTransform, Unit->GetVelocity().Size2D(), Unit->GetUniqueID());
+
+            SetSkeletalVisible(Unit, !bInstanced);
+        }
+    }
+
+    // Crowd rows have no actor at all; drawing them is all there is
+    if (const UUnitCrowdSubsystem* Crowd = GetWorld()->GetSubsystem<UUnitCrowdSubsystem>())
+    {
+        Crowd->ForEachCrowdUnit([this, &ViewLocation, &NearestImage](int32 UnitId, const FVector& Location, const FVector& Velocity, TSubclassOf<AUnitBase> UnitClass, EUnitSex Sex)
+        {
+            const AUnitBase* Defaults = UnitClass ? UnitClass->GetDefaultObject<AUnitBase>() : nullptr;
+            const FUnitCrowdVisual* Visual = Defaults ? Defaults->GetCrowdVisual(Sex) : nullptr;
+            const FVector ImageLocation = NearestImage(Location);
+            if (!Visual || FVector::DistSquared(ViewLocation, ImageLocation) > FMath::Square(MaxDrawDistance))
+            {
+                return;
+            }
+
+            // Same mesh offset as the skeletal mesh the visual was baked from
+            const FTransform UnitTransform(Velocity.IsNearlyZero() ? FRotator::ZeroRotator : Velocity.Rotation(), ImageLocation);
+            AddInstance(*Visual, Defaults->GetMesh()->GetRelativeTransform() * UnitTransform, Velocity.Size2D(), GetTypeHash(UnitId));
+        });
+    }
+
+    NumInstances = 0;
+    for (const TPair<UStaticMesh*, UInstancedStaticMeshComponent*>& Pair : Components)
+    {
+        static const FCrowdInstanceBatch EmptyBatch;
+        const FCrowdInstanceBatch* Batch = Batches.Find(Pair.Key);
+        FlushBatch(Pair.Value, Batch ? *Batch : EmptyBatch);
+        NumInstances += Batch ? Batch->Transforms.Num() : 0;
+    }
+}
+
+bool UUnitCrowdRenderSubsystem::AddInstance(const FUnitCrowdVisual& Visual, const FTransform& Transform, float GroundSpeed, uint32 Seed)
+{
+    UStaticMesh* Mesh = Visual.Mesh.Get();
+    if (!Mesh || !Components.Contains(Mesh))
+    {
+        RequestMesh(Visual);
+        return false;
+    }
+
+    const bool bWalking = GroundSpeed > WalkSpeedThreshold;
+    const FUnitVertexAnimClip& Clip = bWalking ? Visual.Walk : Visual.Idle;
+
+    // Walk cadence follows ground speed so feet don't slide
+    const float FramesPerSecond = bWalking ? Clip.FrameRate * GroundSpeed / Visual.WalkReferenceSpeed : Clip.FrameRate;
+    const float TimeOffset = static_cast<float>(Seed % 1000) * 0.01f;
+
+    FCrowdInstanceBatch& Batch = Batches.FindOrAdd(Mesh);
+    Batch.Transforms.Add(Transform);
+    Batch.CustomData.Add(static_cast<float>(Clip.StartFrame));
+    Batch.CustomData.Add(static_cast<float>(Clip.NumFrames));
+    Batch.CustomData.Add(TimeOffset);
+    Batch.CustomData.Add(FramesPerSecond);
+    return true;
+}
+
+void UUnitCrowdRenderSubsystem::RequestMesh(const FUnitCrowdVisual& Visual)
+{
+    const FSoftObjectPath MeshPath = Visual.Mesh.ToSoftObjectPath();
+    if (MeshPath.IsNull())
+    {
+        return;
+    }
+
+    // Already loaded by someone else
+    if (UStaticMesh* Mesh = Visual.Mesh.Get())
+    {
+        CreateComponent(Mesh);
+        return;
+    }
+
+    if (PendingMeshes.Contains(MeshPath))
+    {
+        return;
+    }
+    PendingMeshes.Add(MeshPath);
+
+    TWeakObjectPtr<UUnitCrowdRenderSubsystem> WeakThis(this);
+    UUnitAssetCache::Load(this, MeshPath, FSimpleDelegate::CreateLambda([WeakThis, MeshPath]()
+    {
+        UUnitCrowdRenderSubsystem* This = WeakThis.Get();
+        if (!This)
+        {
+            return;
+        }
+
+        This->PendingMeshes.Remove(MeshPath);
+        if (UStaticMesh* Mesh = Cast<UStaticMesh>(MeshPath.ResolveObject()))
+        {
+            This->CreateComponent(Mesh);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("UnitCrowdRender: Failed to load crowd mesh %s"), *MeshPath.ToString());
+        }
+    }));
+}
+
+UInstancedStaticMeshComponent* UUnitCrowdRenderSubsystem::CreateComponent(UStaticMesh* Mesh)
+{
+    if (UInstancedStaticMeshComponent** Existing = Components.Find(Mesh))
+    {
+        return *Existing;
+    }
+
+    if (!HostActor)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.ObjectFlags |= RF_Transient;
+        HostActor = GetWorld()->SpawnActor<AActor>(SpawnParams);
+        HostActor->SetRootComponent(NewObject<USceneComponent>(HostActor, TEXT("Root")));
+        HostActor->GetRootComponent()->RegisterComponent();
+    }
+
+    // One draw per baked mesh; the material animates every instance on the GPU
+    UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(HostActor);
+    Component->SetMobility(EComponentMobility::Movable);
+    Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Component->SetCanEverAffectNavigation(false);
+    Component->SetStaticMesh(Mesh);
+    Component->SetNumCustomDataFloats(NumCustomDataFloats);
+    Component->RegisterComponent();
+    HostActor->AddInstanceComponent(Component);
+
+    Components.Add(Mesh, Component);
+    return Component;
+}
+
+void UUnitCrowdRenderSubsystem::FlushBatch(UInstancedStaticMeshComponent* Component, const FCrowdInstanceBatch& Batch)
+{
+    const int32 NumWanted = Batch.Transforms.Num();
+    int32 NumExisting = Component->GetInstanceCount();
+    if (NumWanted == 0 && NumExisting == 0)
+    {
+        return;
+    }
+
+    // Trim from the back so no instance indices shift
+    while (NumExisting > NumWanted)
+    {
+        Component->RemoveInstance(--NumExisting);
+    }
+
+    for (int32 i = 0; i < NumExisting; ++i)
+    {
+        Component->UpdateInstanceTransform(i, Batch.Transforms[i], true, false, true);
+    }
+
+    if (NumWanted > NumExisting)
+    {
+        const TArray<FTransform> NewTransforms(Batch.Transforms.GetData() + NumExisting, NumWanted - NumExisting);
+        Component->AddInstances(NewTransforms, false, true, false);
+    }
+
+    for (int32 i = 0; i < NumWanted; ++i)
+    {
+        Component->SetCustomData(i, TArrayView<const float>(Batch.CustomData.GetData() + i * NumCustomDataFloats, NumCustomDataFloats), false);
+    }
+
+    Component->MarkRenderStateDirty();
+}
+
+void UUnitCrowdRenderSubsystem::SetSkeletalVisible(AUnitBase* Unit, bool bVisible)
+{
+    USkeletalMeshComponent* MeshComp = Unit->GetMesh();
+    if (MeshComp->IsVisible() != bVisible)
+    {
+        MeshComp->SetVisibility(bVisible);
+    }
+}
@@ -0,0 +1,506 @@
+#include "UnitCrowdSubsystem.h"
+#include "UnitController.h"
+#include "UnitPoolSubsystem.h"
+#include "Toroid.h"
+#include "ToroidalMath.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    // Rows per ParallelFor task when stepping
+    constexpr int32 StepChunkSize = 1024;
+}
+
+bool UUnitCrowdSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UUnitCrowdSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UUnitCrowdSubsystem::Tick(float DeltaTime)
+{
+    // Clients only ever see promoted actors
+    if (GetWorld()->GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    StepRows(DeltaTime);
+
+    TimeSinceTierUpdate += DeltaTime;
+    if (TimeSinceTierUpdate >= TierUpdateInterval)
+    {
+        TimeSinceTierUpdate = 0.0f;
+        UpdateTiers();
+    }
+}
+
+int32 UUnitCrowdSubsystem::AddCrowdUnit(TSubclassOf<AUnitBase> UnitClass, const FVector& Location, int32 TeamId)
+{
+    const int32 UnitId = NextUnitId++;
+    const int32 Row = AddRow(UnitId, UnitClass, Location, TeamId);
+
+    // Class defaults for everything the caller didn't give us
+    const AUnitBase* Defaults = UnitClass ? UnitClass->GetDefaultObject<AUnitBase>() : GetDefault<AUnitBase>();
+    Ages[Row] = Defaults->Age;
+    Strengths[Row] = Defaults->Strength;
+    SeeingRanges[Row] = Defaults->SeeingRange;
+    Sexes[Row] = Defaults->UnitSex;
+    Speed[Row] = Defaults->UnitMovementSpeed;
+
+    return UnitId;
+}
+
+bool UUnitCrowdSubsystem::RemoveCrowdUnit(int32 UnitId)
+{
+    const int32* Row = IdToRow.Find(UnitId);
+    if (!Row)
+    {
+        return false;
+    }
+
+    RemoveRow(*Row);
+    return true;
+}
+
+bool UUnitCrowdSubsystem::SetCrowdUnitGoal(int32 UnitId, const FVector& Goal)
+{
+    const int32* Row = IdToRow.Find(UnitId);
+    if (!Row)
+    {
+        return false;
+    }
+
+    GoalX[*Row] = Goal.X;
+    GoalY[*Row] = Goal.Y;
+    HasGoal[*Row] = true;
+    return true;
+}
+
+int32 UUnitCrowdSubsystem::GetNumCrowdUnitsOfTeam(int32 TeamId) const
+{
+    int32 Count = 0;
+    for (const int32 Team : Teams)
+    {
+        Count += Team == TeamId ? 1 : 0;
+    }
+    return Count;
+}
+
+bool UUnitCrowdSubsystem::GetCrowdUnitLocation(int32 UnitId, FVector& OutLocation) const
+{
+    const int32* Row = IdToRow.Find(UnitId);
+    if (!Row)
+    {
+        return false;
+    }
+
+    OutLocation = FVector(PositionX[*Row], PositionY[*Row], PositionZ[*Row]);
+    return true;
+}
+
+void UUnitCrowdSubsystem::ForEachCrowdUnit(TFunctionRef<void(int32 UnitId, const FVector& Location, const FVector& Velocity, TSubclassOf<AUnitBase> UnitClass, EUnitSex Sex)> Visitor) const
+{
+    for (int32 Row = 0; Row < Ids.Num(); ++Row)
+    {
+        Visitor(Ids[Row], FVector(PositionX[Row], PositionY[Row], PositionZ[Row]), FVector(VelocityX[Row], VelocityY[Row], 0.0f), UnitClasses[Row], Sexes[Row]);
+    }
+}
+
+// Rows are only ever drawn as instances; a unit without a crowd visual would vanish
+static bool CanBeCrowdRow(const AUnitBase* Unit)
+{
+    return Unit->bAllowCrowdSimulation && Unit->GetCrowdVisual(Unit->GetUnitSex()) != nullptr;
+}
+
+// A row only remembers one goal, so units with queued or patrol orders stay actors
+static bool HasStandingOrders(const AUnitBase* Unit)
+{
+    const AUnitController* Controller = Cast<AUnitController>(Unit->GetController());
+    return Controller && (Controller->GetNumQueuedCommands() > 0 || Controller->GetCurrentCommand().CommandType == EUnitCommandType::Patrol);
+}
+
+int32 UUnitCrowdSubsystem::DemoteUnit(AUnitBase* Unit)
+{
+    // Selected units stay actors; the selection manager holds on to them
+    if (!Unit || !CanBeCrowdRow(Unit) || Unit->GetIsSelected() || Unit->IsPooled() || Unit->IsActorBeingDestroyed() || HasStandingOrders(Unit))
+    {
+        return INDEX_NONE;
+    }
+
+    const int32 UnitId = Unit->CrowdUnitId != INDEX_NONE ? Unit->CrowdUnitId : NextUnitId++;
+    const int32 Row = AddRow(UnitId, Unit->GetClass(), Unit->GetActorLocation(), Unit->GetTeamId());
+
+    Ages[Row] = Unit->Age;
+    Strengths[Row] = Unit->Strength;
+    SeeingRanges[Row] = Unit->SeeingRange;
+    Sexes[Row] = Unit->GetUnitSex();
+    Speed[Row] = Unit->GetCharacterMovement() ? Unit->GetCharacterMovement()->MaxWalkSpeed : Unit->UnitMovementSpeed;
+
+    const FVector Velocity = Unit->GetVelocity();
+    VelocityX[Row] = Velocity.X;
+    VelocityY[Row] = Velocity.Y;
+
+    // Keep walking to wherever the controller was headed
+    if (const AUnitController* Controller = Cast<AUnitController>(Unit->GetController()))
+    {
+        if (Controller->IsMoving())
+        {
+            const FVector Goal = Controller->GetCurrentDestination();
+            GoalX[Row] = Goal.X;
+            GoalY[Row] = Goal.Y;
+            HasGoal[Row] = true;
+        }
+    }
+
+    // Recycled for the next promotion if there is a pool; the AI controller goes with its pawn either way
+    if (UUnitPoolSubsystem* Pool = GetWorld()->GetSubsystem<UUnitPoolSubsystem>())
+    {
+        Pool->ReleaseUnit(Unit);
+    }
+    else
+    {
+        Unit->Destroy();
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("UnitCrowd: Demoted unit %d"), UnitId);
+    return UnitId;
+}
+
+AUnitBase* UUnitCrowdSubsystem::PromoteUnit(int32 UnitId)
+{
+    const int32* RowPtr = IdToRow.Find(UnitId);
+    if (!RowPtr)
+    {
+        return nullptr;
+    }
+    const int32 Row = *RowPtr;
+
+    UClass* UnitClass = UnitClasses[Row] ? UnitClasses[Row].Get() : AUnitBase::StaticClass();
+    const FVector Location(PositionX[Row], PositionY[Row], PositionZ[Row]);
+    const FVector Velocity(VelocityX[Row], VelocityY[Row], 0.0f);
+    const FTransform SpawnTransform(Velocity.IsNearlyZero() ? FRotator::ZeroRotator : Velocity.Rotation(), Location);
+
+    UUnitPoolSubsystem* Pool = GetWorld()->GetSubsystem<UUnitPoolSubsystem>();
+    AUnitBase* Unit = Pool ? Pool->AcquireUnit(UnitClass, SpawnTransform, Teams[Row], Sexes[Row]) : nullptr;
+    if (!Unit)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("UnitCrowd: Failed to promote unit %d"), UnitId);
+        return nullptr;
+    }
+
+    Unit->Age = Ages[Row];
+    Unit->Strength = Strengths[Row];
+    Unit->SeeingRange = SeeingRanges[Row];
+    Unit->UnitMovementSpeed = Speed[Row];
+    Unit->CrowdUnitId = UnitId;
+
+    if (UCharacterMovementComponent* MovementComp = Unit->GetCharacterMovement())
+    {
+        MovementComp->MaxWalkSpeed = Speed[Row];
+        MovementComp->Velocity = Velocity;
+    }
+
+    const bool bHadGoal = HasGoal[Row];
+    const FVector Goal(GoalX[Row], GoalY[Row], PositionZ[Row]);
+    RemoveRow(Row);
+
+    if (bHadGoal)
+    {
+        if (AUnitController* Controller = Cast<AUnitController>(Unit->GetController()))
+        {
+            Controller->MoveToLocation(Goal);
+        }
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("UnitCrowd: Promoted unit %d"), UnitId);
+    return Unit;
+}
+
+int32 UUnitCrowdSubsystem::AddRow(int32 UnitId, TSubclassOf<AUnitBase> UnitClass, const FVector& Location, int32 TeamId)
+{
+    const int32 Row = Ids.Add(UnitId);
+    PositionX.Add(Location.X);
+    PositionY.Add(Location.Y);
+    PositionZ.Add(Location.Z);
+    VelocityX.Add(0.0f);
+    VelocityY.Add(0.0f);
+    GoalX.Add(Location.X);
+    GoalY.Add(Location.Y);
+    HasGoal.Add(false);
+    Speed.Add(0.0f);
+    Teams.Add(TeamId);
+    Ages.Add(0);
+    Strengths.Add(0.0f);
+    SeeingRanges.Add(0.0f);
+    Sexes.Add(EUnitSex::Male);
+    UnitClasses.Add(UnitClass);
+
+    IdToRow.Add(UnitId, Row);
+    return Row;
+}
+
+void UUnitCrowdSubsystem::RemoveRow(int32 Row)
+{
+    IdToRow.Remove(Ids[Row]);
+
+    Ids.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    PositionX.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    PositionY.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    PositionZ.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    VelocityX.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    VelocityY.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    GoalX.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    GoalY.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    HasGoal.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    Speed.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    Teams.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    Ages.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    Strengths.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    SeeingRanges.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    Sexes.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+    UnitClasses.RemoveAtSwap(Row, 1, EAllowShrinking::No);
+
+    // The last row moved into the hole
+    if (Row < Ids.Num())
+    {
+        IdToRow.Add(Ids[Row], Row);
+    }
+}
+
+void UUnitCrowdSubsystem::StepRows(float DeltaTime)
+{
+    const int32 NumRows = Ids.Num();
+    if (NumRows == 0 || DeltaTime <= 0.0f)
+    {
+        return;
+    }
+
+    // Steer along the shortest toroidal offset and keep rows on the map
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(GetWorld());
+    const bool bWrap = ToroidalWorld != nullptr;
+    const float WorldWidth = bWrap ? ToroidalWorld->WorldWidth : 0.0f;
+    const float WorldHeight = bWrap ? ToroidalWorld->WorldHeight : 0.0f;
+    const FVector WorldCenter = bWrap ? ToroidalWorld->WorldCenter : FVector::ZeroVector;
+    const float ArrivalRadiusSquared = FMath::Square(ArrivalRadius);
+
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumRows, StepChunkSize);
+    ParallelFor(TEXT("UnitCrowdStep"), NumChunks, 1, [&](int32 ChunkIndex)
+    {
+        const int32 First = ChunkIndex * StepChunkSize;
+        const int32 Last = FMath::Min(First + StepChunkSize, NumRows);
+
+        for (int32 i = First; i < Last; ++i)
+        {
+            if (!HasGoal[i])
+            {
+                VelocityX[i] = 0.0f;
+                VelocityY[i] = 0.0f;
+                continue;
+            }
+
+            float DX = GoalX[i] - PositionX[i];
+            float DY = GoalY[i] - PositionY[i];
+            if (bWrap)
+            {
+                DX = FToroidalMath::Wrap(DX, WorldWidth);
+                DY = FToroidalMath::Wrap(DY, WorldHeight);
+            }
+
+            const float DistanceSquared = DX * DX + DY * DY;
+            const float StepLength = Speed[i] * DeltaTime;
+
+            if (DistanceSquared <= FMath::Square(StepLength))
+            {
+                // Lands this step
+                PositionX[i] += DX;
+                PositionY[i] += DY;
+                VelocityX[i] = 0.0f;
+                VelocityY[i] = 0.0f;
+                HasGoal[i] = false;
+            }
+            else if (DistanceSquared <= ArrivalRadiusSquared)
+            {
+                VelocityX[i] = 0.0f;
+                VelocityY[i] = 0.0f;
+                HasGoal[i] = false;
+            }
+            else
+            {
+                const float Scale = Speed[i] * FMath::InvSqrt(DistanceSquared);
+                VelocityX[i] = DX * Scale;
+                VelocityY[i] = DY * Scale;
+                PositionX[i] += VelocityX[i] * DeltaTime;
+                PositionY[i] += VelocityY[i] * DeltaTime;
+            }
+
+            if (bWrap)
+            {
+                PositionX[i] = WorldCenter.X + FToroidalMath::Wrap(PositionX[i] - WorldCenter.X, WorldWidth);
+                PositionY[i] = WorldCenter.Y + FToroidalMath::Wrap(PositionY[i] - WorldCenter.Y, WorldHeight);
+            }
+        }
+    });
+}
+
+void UUnitCrowdSubsystem::UpdateTiers()
+{
+    TArray<FBox2D> Footprints;
+    GatherViewFootprints(Footprints);
+
+    // Nobody is watching (headless server without players): leave tiers alone
+    if (Footprints.Num() == 0)
+    {
+        return;
+    }
+
+    int32 Budget = MaxTierChangesPerUpdate;
+
+    // Demote first so a busy frame frees room before spawning
+    TArray<AUnitBase*> ToDemote;
+    for (TActorIterator<AUnitBase> It(GetWorld()); It && ToDemote.Num() < Budget; ++It)
+    {
+        AUnitBase* Unit = *It;
+        if (CanBeCrowdRow(Unit) && !Unit->GetIsSelected() && !Unit->IsPooled() && !Unit->IsActorBeingDestroyed() && !HasStandingOrders(Unit) &&
+            GetDistanceToNearestView(Unit->GetActorLocation(), Footprints) > DemoteRadius)
+        {
+            ToDemote.Add(Unit);
+        }
+    }
+
+    for (AUnitBase* Unit : ToDemote)
+    {
+        if (DemoteUnit(Unit) != INDEX_NONE)
+        {
+            --Budget;
+        }
+    }
+
+    if (Budget <= 0)
+    {
+        return;
+    }
+
+    // Closest rows first when more want in than the budget allows
+    TArray<TPair<float, int32>> Candidates;
+    for (int32 Row = 0; Row < Ids.Num(); ++Row)
+    {
+        const float Distance = GetDistanceToNearestView(FVector(PositionX[Row], PositionY[Row], 0.0f), Footprints);
+        if (Distance <= PromoteRadius)
+        {
+            Candidates.Emplace(Distance, Ids[Row]);
+        }
+    }
+
+    if (Candidates.Num() > Budget)
+    {
+        Candidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+        Candidates.SetNum(Budget, EAllowShrinking::No);
+    }
+
+    for (const TPair<float, int32>& Candidate : Candidates)
+    {
+        PromoteUnit(Candidate.Value);
+    }
+}
+
+void UUnitCrowdSubsystem::GatherViewFootprints(TArray<FBox2D>& OutFootprints) const
+{
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(GetWorld());
+    const float GroundZ = ToroidalWorld ? ToroidalWorld->WorldCenter.Z : 0.0f;
+
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        if (!PC)
+        {
+            continue;
+        }
+
+        FVector ViewLocation;
+        FRotator ViewRotation;
+        PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+        // Remote players' viewports aren't known here; assume a common aspect
+        int32 ViewportX = 16;
+        int32 ViewportY = 9;
+        if (PC->IsLocalController())
+        {
+            int32 SizeX = 0;
+            int32 SizeY = 0;
+            PC->GetViewportSize(SizeX, SizeY);
+            if (SizeX > 0 && SizeY > 0)
+            {
+                ViewportX = SizeX;
+                ViewportY = SizeY;
+            }
+        }
+
+        const float FOV = PC->PlayerCameraManager ? PC->PlayerCameraManager->GetFOVAngle() : 90.0f;
+        const float TanHalfHorizontal = FMath::Tan(FMath::DegreesToRadians(FOV * 0.5f));
+        const float TanHalfVertical = TanHalfHorizontal * ViewportY / ViewportX;
+
+        const FRotationMatrix ViewAxes(ViewRotation);
+        const FVector Forward = ViewAxes.GetScaledAxis(EAxis::X);
+        const FVector Right = ViewAxes.GetScaledAxis(EAxis::Y);
+        const FVector Up = ViewAxes.GetScaledAxis(EAxis::Z);
+
+        // Where the frustum corner rays meet the ground, capped for flat views
+        FBox2D Footprint(ForceInit);
+        Footprint += FVector2D(ViewLocation.X, ViewLocation.Y);
+        for (int32 Corner = 0; Corner < 4; ++Corner)
+        {
+            const float SideX = (Corner & 1) ? 1.0f : -1.0f;
+            const float SideY = (Corner & 2) ? 1.0f : -1.0f;
+            const FVector Ray = (Forward + Right * TanHalfHorizontal * SideX + Up * TanHalfVertical * SideY).GetSafeNormal();
+
+            float Distance = MaxViewDistance;
+            if (Ray.Z < -KINDA_SMALL_NUMBER)
+            {
+                Distance = FMath::Min((GroundZ - ViewLocation.Z) / Ray.Z, MaxViewDistance);
+            }
+
+            const FVector Hit = ViewLocation + Ray * FMath::Max(Distance, 0.0f);
+            Footprint += FVector2D(Hit.X, Hit.Y);
+        }
+
+        OutFootprints.Add(Footprint);
+    }
+}
+
+float UUnitCrowdSubsystem::GetDistanceToNearestView(const FVector& Location, const TArray<FBox2D>& Footprints) const
+{
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(GetWorld());
+
+    float NearestSquared = TNumericLimits<float>::Max();
+    for (const FBox2D& Footprint : Footprints)
+    {
+        // Offset from the footprint centre, taken the short way round the torus
+        const FVector2D Center = Footprint.GetCenter();
+        const FVector2D Extent = Footprint.GetExtent();
+        float DX = Location.X - Center.X;
+        float DY = Location.Y - Center.Y;
+        if (ToroidalWorld)
+        {
+            DX = FToroidalMath::Wrap(DX, ToroidalWorld->WorldWidth);
+            DY = FToroidalMath::Wrap(DY, ToroidalWorld->WorldHeight);
+        }
+
+        // Zero inside the footprint
+        DX = FMath::Max(FMath::Abs(DX) - Extent.X, 0.0f);
+        DY = FMath::Max(FMath::Abs(DY) - Extent.Y, 0.0f);
+        NearestSquared = FMath::Min(NearestSquared, DX * DX + DY * DY);
+    }
+
+    return FMath::Sqrt(NearestSquared);
+}
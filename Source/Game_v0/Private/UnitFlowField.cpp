@@ -0,0 +1,413 @@
+#include "UnitFlowField.h"
+#include "Toroid.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Engine/World.h"
+
+namespace
+{
+    // Vertical reach from the goal when collecting navmesh polygons
+    constexpr float NavQueryHeight = 500.0f;
+
+    constexpr float Unreached = TNumericLimits<float>::Max();
+
+    // Size one grid axis. An axis at least as long as the (wrapping) world
+    // covers it exactly, with cells stretched to divide it evenly.
+    void LayoutAxis(float HalfExtent, float CellSize, float WorldSize, int32& OutNum, float& OutCellSize, bool& bOutWrap, double& OutOrigin)
+    {
+        if (WorldSize > 0.0f && 2.0f * HalfExtent >= WorldSize)
+        {
+            OutNum = FMath::Max(1, FMath::FloorToInt(WorldSize / CellSize));
+            OutCellSize = WorldSize / OutNum;
+            bOutWrap = true;
+            OutOrigin = -0.5 * WorldSize;
+        }
+        else
+        {
+            OutNum = FMath::Max(1, FMath::CeilToInt(2.0f * HalfExtent / CellSize));
+            OutCellSize = CellSize;
+            bOutWrap = false;
+            OutOrigin = -0.5 * OutNum * CellSize;
+        }
+    }
+}
+
+bool FUnitFlowField::Build(UWorld* World, const FVector& InGoal, float InGoalRadius, const TArray<FVector>& StartLocations, float InCellSize)
+{
+    if (!World || StartLocations.Num() == 0)
+    {
+        return false;
+    }
+
+    ToroidalWorld = UToroidalWorldManager::Get(World);
+    Goal = InGoal;
+    GoalRadius = FMath::Max(InGoalRadius, 1.0f);
+
+    // Big enough for the whole group, plus room to walk around things
+    float HalfX = GoalRadius;
+    float HalfY = GoalRadius;
+    for (const FVector& Start : StartLocations)
+    {
+        const FVector Offset = GetOffset(Start);
+        HalfX = FMath::Max(HalfX, FMath::Abs(static_cast<float>(Offset.X)));
+        HalfY = FMath::Max(HalfY, FMath::Abs(static_cast<float>(Offset.Y)));
+    }
+    HalfX += BoundsMargin;
+    HalfY += BoundsMargin;
+
+    float CellSize = FMath::Max(InCellSize, 10.0f);
+    const double EstimatedCells = (2.0 * HalfX / CellSize) * (2.0 * HalfY / CellSize);
+    if (EstimatedCells > MaxCells)
+    {
+        CellSize *= FMath::Sqrt(EstimatedCells / MaxCells);
+    }
+
+    const UToroidalWorldManager* Torus = ToroidalWorld.Get();
+    LayoutAxis(HalfX, CellSize, Torus ? Torus->WorldWidth : 0.0f, NumX, CellSizeX, bWrapX, GridOrigin.X);
+    LayoutAxis(HalfY, CellSize, Torus ? Torus->WorldHeight : 0.0f, NumY, CellSizeY, bWrapY, GridOrigin.Y);
+
+    // Cost field: a cell is walkable if it lies on the navmesh. Without a
+    // navmesh everything is open, as before nav data is built.
+    const ARecastNavMesh* NavMesh = nullptr;
+    if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World))
+    {
+        NavMesh = Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance());
+    }
+
+    Blocked.Init(NavMesh != nullptr, NumX * NumY);
+    if (NavMesh)
+    {
+        MarkWalkableCells(*NavMesh);
+    }
+
+    Integrate();
+    BuildDirections();
+
+    UE_LOG(LogTemp, Log, TEXT("UnitFlowField: %dx%d cells of %.0fx%.0f towards %s%s"), NumX, NumY, CellSizeX, CellSizeY,
+           *Goal.ToString(), (bWrapX || bWrapY) ? TEXT(" (wrapping)") : TEXT(""));
+    return true;
+}
+
+void FUnitFlowField::MarkWalkableCells(const ARecastNavMesh& NavMesh)
+{
+    // One pass over the polygons of the tiles under the grid, instead of a
+    // navmesh query per cell. On a torus the grid can reach past the map
+    // edge; those parts are looked up where they really are, across the seam.
+    const FBox GridBox(Goal + FVector(GridOrigin.X, GridOrigin.Y, -NavQueryHeight),
+                       Goal + FVector(GridOrigin.X + NumX * CellSizeX, GridOrigin.Y + NumY * CellSizeY, NavQueryHeight));
+
+    TArray<FBox> Bounds;
+    if (const UToroidalWorldManager* Torus = ToroidalWorld.Get())
+    {
+        for (int32 ShiftY = -1; ShiftY <= 1; ++ShiftY)
+        {
+            for (int32 ShiftX = -1; ShiftX <= 1; ++ShiftX)
+            {
+                Bounds.Add(GridBox.ShiftBy(FVector(ShiftX * Torus->WorldWidth, ShiftY * Torus->WorldHeight, 0.0f)));
+            }
+        }
+    }
+    else
+    {
+        Bounds.Add(GridBox);
+    }
+
+    TArray<int32> Tiles;
+    NavMesh.GetNavMeshTilesIn(Bounds, Tiles);
+
+    TArray<FNavPoly> Polys;
+    TArray<FVector> Verts;
+    TArray<FVector2D> Corners;
+    for (const int32 Tile : Tiles)
+    {
+        Polys.Reset();
+        NavMesh.GetPolysInTile(Tile, Polys);
+
+        for (const FNavPoly& Poly : Polys)
+        {
+            // Only the level the group walks on
+            if (FMath::Abs(Poly.Center.Z - Goal.Z) > NavQueryHeight)
+            {
+                continue;
+            }
+
+            Verts.Reset();
+            if (!NavMesh.GetPolyVerts(Poly.Ref, Verts) || Verts.Num() < 3)
+            {
+                continue;
+            }
+
+            // Goal-relative corners; polygons are small, so one toroidal offset for the centre does
+            const FVector CenterOffset = GetOffset(Poly.Center);
+            Corners.Reset();
+            FBox2D PolyBounds(ForceInit);
+            for (const FVector& Vert : Verts)
+            {
+                const FVector2D Corner(CenterOffset.X + Vert.X - Poly.Center.X, CenterOffset.Y + Vert.Y - Poly.Center.Y);
+                Corners.Add(Corner);
+                PolyBounds += Corner;
+            }
+
+            // Polygons smaller than a cell still open the cell they sit in
+            const int32 CenterCell = GetCellIndex(CenterOffset);
+            if (CenterCell != INDEX_NONE)
+            {
+                Blocked[CenterCell] = false;
+            }
+
+            // Cells whose centre falls inside the polygon's bounds. Indices are
+            // kept unwrapped so cell centres compare with the corners directly.
+            int32 MinX = FMath::CeilToInt((PolyBounds.Min.X - GridOrigin.X) / CellSizeX - 0.5);
+            int32 MaxX = FMath::FloorToInt((PolyBounds.Max.X - GridOrigin.X) / CellSizeX - 0.5);
+            int32 MinY = FMath::CeilToInt((PolyBounds.Min.Y - GridOrigin.Y) / CellSizeY - 0.5);
+            int32 MaxY = FMath::FloorToInt((PolyBounds.Max.Y - GridOrigin.Y) / CellSizeY - 0.5);
+            if (!bWrapX)
+            {
+                MinX = FMath::Max(MinX, 0);
+                MaxX = FMath::Min(MaxX, NumX - 1);
+            }
+            if (!bWrapY)
+            {
+                MinY = FMath::Max(MinY, 0);
+                MaxY = FMath::Min(MaxY, NumY - 1);
+            }
+
+            for (int32 Y = MinY; Y <= MaxY; ++Y)
+            {
+                for (int32 X = MinX; X <= MaxX; ++X)
+                {
+                    // Navmesh polygons are convex: inside if on the same side of every edge
+                    const FVector Cell = GetCellOffset(X, Y);
+                    bool bHasPositive = false;
+                    bool bHasNegative = false;
+                    for (int32 i = 0; i < Corners.Num(); ++i)
+                    {
+                        const FVector2D& A = Corners[i];
+                        const FVector2D& B = Corners[(i + 1) % Corners.Num()];
+                        const double Side = FVector2D::CrossProduct(B - A, FVector2D(Cell.X, Cell.Y) - A);
+                        bHasPositive |= Side > 0.0;
+                        bHasNegative |= Side < 0.0;
+                    }
+                    if (bHasPositive && bHasNegative)
+                    {
+                        continue;
+                    }
+
+                    const int32 WrappedX = bWrapX ? (X % NumX + NumX) % NumX : X;
+                    const int32 WrappedY = bWrapY ? (Y % NumY + NumY) % NumY : Y;
+                    Blocked[WrappedY * NumX + WrappedX] = false;
+                }
+            }
+        }
+    }
+}
+
+void FUnitFlowField::Integrate()
+{
+    const int32 NumCells = NumX * NumY;
+    Integration.Init(Unreached, NumCells);
+
+    TArray<TPair<float, int32>> Open;
+    const auto CheaperFirst = [](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; };
+
+    // Seed with every walkable cell inside the goal region, and the goal's own cell regardless
+    for (int32 Y = 0; Y < NumY; ++Y)
+    {
+        for (int32 X = 0; X < NumX; ++X)
+        {
+            const int32 Index = Y * NumX + X;
+            if (!Blocked[Index] && GetCellOffset(X, Y).Size2D() <= GoalRadius)
+            {
+                Integration[Index] = 0.0f;
+                Open.HeapPush(TPair<float, int32>(0.0f, Index), CheaperFirst);
+            }
+        }
+    }
+
+    const int32 GoalCell = GetCellIndex(FVector::ZeroVector);
+    if (GoalCell != INDEX_NONE && Integration[GoalCell] != 0.0f)
+    {
+        Integration[GoalCell] = 0.0f;
+        Open.HeapPush(TPair<float, int32>(0.0f, GoalCell), CheaperFirst);
+    }
+
+    // Plain Dijkstra over 8-connected cells
+    while (Open.Num() > 0)
+    {
+        TPair<float, int32> Current;
+        Open.HeapPop(Current, CheaperFirst, EAllowShrinking::No);
+        if (Current.Key > Integration[Current.Value])
+        {
+            continue;
+        }
+
+        const int32 X = Current.Value % NumX;
+        const int32 Y = Current.Value / NumX;
+
+        for (int32 DY = -1; DY <= 1; ++DY)
+        {
+            for (int32 DX = -1; DX <= 1; ++DX)
+            {
+                if (DX == 0 && DY == 0)
+                {
+                    continue;
+                }
+
+                int32 NX = X + DX;
+                int32 NY = Y + DY;
+                if (bWrapX)
+                {
+                    NX = (NX + NumX) % NumX;
+                }
+                if (bWrapY)
+                {
+                    NY = (NY + NumY) % NumY;
+                }
+                if (NX < 0 || NX >= NumX || NY < 0 || NY >= NumY)
+                {
+                    continue;
+                }
+
+                const int32 Neighbour = NY * NumX + NX;
+                if (Blocked[Neighbour])
+                {
+                    continue;
+                }
+
+                // No cutting corners past blocked cells
+                if (DX != 0 && DY != 0 && (Blocked[Y * NumX + NX] || Blocked[NY * NumX + X]))
+                {
+                    continue;
+                }
+
+                const float StepCost = FMath::Sqrt(FMath::Square(DX * CellSizeX) + FMath::Square(DY * CellSizeY));
+                const float NewCost = Current.Key + StepCost;
+                if (NewCost < Integration[Neighbour])
+                {
+                    Integration[Neighbour] = NewCost;
+                    Open.HeapPush(TPair<float, int32>(NewCost, Neighbour), CheaperFirst);
+                }
+            }
+        }
+    }
+}
+
+void FUnitFlowField::BuildDirections()
+{
+    Directions.Init(FVector2f::ZeroVector, NumX * NumY);
+
+    for (int32 Y = 0; Y < NumY; ++Y)
+    {
+        for (int32 X = 0; X < NumX; ++X)
+        {
+            const int32 Index = Y * NumX + X;
+            if (Integration[Index] == Unreached)
+            {
+                continue;
+            }
+
+            // Goal cells point at the goal itself
+            if (Integration[Index] == 0.0f)
+            {
+                const FVector ToGoal = -GetCellOffset(X, Y);
+                Directions[Index] = FVector2f(ToGoal.X, ToGoal.Y).GetSafeNormal();
+                continue;
+            }
+
+            // Otherwise downhill, to the cheapest neighbour (same corner rule as Integrate)
+            float BestCost = Integration[Index];
+            FVector2f BestStep = FVector2f::ZeroVector;
+            for (int32 DY = -1; DY <= 1; ++DY)
+            {
+                for (int32 DX = -1; DX <= 1; ++DX)
+                {
+                    int32 NX = X + DX;
+                    int32 NY = Y + DY;
+                    if (bWrapX)
+                    {
+                        NX = (NX + NumX) % NumX;
+                    }
+                    if (bWrapY)
+                    {
+                        NY = (NY + NumY) % NumY;
+                    }
+                    if ((DX == 0 && DY == 0) || NX < 0 || NX >= NumX || NY < 0 || NY >= NumY)
+                    {
+                        continue;
+                    }
+                    if (DX != 0 && DY != 0 && (Blocked[Y * NumX + NX] || Blocked[NY * NumX + X]))
+                    {
+                        continue;
+                    }
+
+                    const float NeighbourCost = Integration[NY * NumX + NX];
+                    if (NeighbourCost < BestCost)
+                    {
+                        BestCost = NeighbourCost;
+                        BestStep = FVector2f(DX * CellSizeX, DY * CellSizeY);
+                    }
+                }
+            }
+
+            Directions[Index] = BestStep.GetSafeNormal();
+        }
+    }
+}
+
+bool FUnitFlowField::SampleDirection(const FVector& Location, FVector& OutDirection) const
+{
+    const int32 Index = GetCellIndex(GetOffset(Location));
+    if (Index == INDEX_NONE || Integration[Index] == Unreached || Directions[Index].IsNearlyZero())
+    {
+        return false;
+    }
+
+    OutDirection = FVector(Directions[Index].X, Directions[Index].Y, 0.0f);
+    return true;
+}
+
+bool FUnitFlowField::IsInGoalRegion(const FVector& Location) const
+{
+    return GetOffset(Location).Size2D() <= GoalRadius;
+}
+
+FVector FUnitFlowField::GetOffset(const FVector& Location) const
+{
+    if (const UToroidalWorldManager* Torus = ToroidalWorld.Get())
+    {
+        const FVector Delta = Torus->GetToroidalDelta(Goal, Location);
+        return FVector(Delta.X, Delta.Y, 0.0f);
+    }
+
+    return FVector(Location.X - Goal.X, Location.Y - Goal.Y, 0.0f);
+}
+
+int32 FUnitFlowField::GetCellIndex(const FVector& Offset) const
+{
+    if (NumX == 0 || NumY == 0)
+    {
+        return INDEX_NONE;
+    }
+
+    int32 X = FMath::FloorToInt((Offset.X - GridOrigin.X) / CellSizeX);
+    int32 Y = FMath::FloorToInt((Offset.Y - GridOrigin.Y) / CellSizeY);
+    if (bWrapX)
+    {
+        X = (X % NumX + NumX) % NumX;
+    }
+    if (bWrapY)
+    {
+        Y = (Y % NumY + NumY) % NumY;
+    }
+
+    if (X < 0 || X >= NumX || Y < 0 || Y >= NumY)
+    {
+        return INDEX_NONE;
+    }
+    return Y * NumX + X;
+}
+
+FVector FUnitFlowField::GetCellOffset(int32 X, int32 Y) const
+{
+    return FVector(GridOrigin.X + (X + 0.5) * CellSizeX, GridOrigin.Y + (Y + 0.5) * CellSizeY, 0.0);
+}
@@ -0,0 +1,852 @@
+#include "UnitLockstepSubsystem.h"
+#include "UnitBase.h"
+#include "UnitController.h"
+#include "BuildingPlayerController.h"
+#include "CustomPlayerState.h"
+#include "Toroid.h"
+#include "EngineUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Misc/Crc.h"
+
+DECLARE_CYCLE_STAT(TEXT("Unit Lockstep"), STAT_UnitLockstep, STATGROUP_Game);
+
+namespace
+{
+    // Same depth as AUnitController's queue
+    constexpr int32 MaxQueuedCommands = 16;
+
+    // Own checksums kept for comparing late reports
+    constexpr int32 ChecksumHistory = 64;
+
+    // Submissions further ahead than this are refused
+    constexpr int32 MaxTurnsAhead = 64;
+
+    // Integer square root, rounded down; bit-identical everywhere unlike FMath::Sqrt
+    uint64 IntegerSqrt(uint64 Value)
+    {
+        uint64 Result = 0;
+        uint64 Bit = uint64(1) << 62;
+        while (Bit > Value)
+        {
+            Bit >>= 2;
+        }
+
+        while (Bit != 0)
+        {
+            if (Value >= Result + Bit)
+            {
+                Value -= Result + Bit;
+                Result = (Result >> 1) + Bit;
+            }
+            else
+            {
+                Result >>= 1;
+            }
+            Bit >>= 2;
+        }
+        return Result;
+    }
+}
+
+bool UUnitLockstepSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UUnitLockstepSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitLockstepSubsystem, STATGROUP_Tickables);
+}
+
+void UUnitLockstepSubsystem::Tick(float DeltaTime)
+{
+    if (!bRunning)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_UnitLockstep);
+
+    // Players that left no longer hold turns up
+    if (GetWorld()->GetNetMode() != NM_Client)
+    {
+        TryDispatchTurns();
+    }
+
+    const float StepTime = 1.0f / StepsPerSecond;
+    Accumulator += DeltaTime;
+    bStalled = false;
+
+    while (Accumulator >= StepTime)
+    {
+        if (StepInTurn == 0)
+        {
+            const FLockstepTurn* Turn = ReadyTurns.Find(CurrentTurn);
+            if (!Turn)
+            {
+                // Resume with one step's worth instead of racing to catch up
+                bStalled = true;
+                Accumulator = StepTime;
+                break;
+            }
+
+            ApplyTurn(*Turn);
+            ReadyTurns.Remove(CurrentTurn);
+            SendSubmission(CurrentTurn + TurnDelay);
+        }
+
+        StepSimulation();
+        Accumulator -= StepTime;
+
+        if (++StepInTurn == StepsPerTurn)
+        {
+            FinishTurn();
+        }
+    }
+
+    UpdatePresentation(bStalled ? 1.0f : Accumulator / StepTime);
+}
+
+bool UUnitLockstepSubsystem::StartLockstep()
+{
+    UWorld* World = GetWorld();
+    if (bRunning || World->GetNetMode() == NM_Client)
+    {
+        return false;
+    }
+
+    if (!InitializeSpace())
+    {
+        return false;
+    }
+
+    FLockstepStart Start;
+    Start.StepsPerSecond = StepsPerSecond;
+    Start.StepsPerTurn = StepsPerTurn;
+    Start.TurnDelay = TurnDelay;
+
+    DispatchedUnits.Reset();
+    DispatchedIds.Reset();
+    PendingLeaves.Reset();
+
+    // Hidden units are pooled, not in play
+    for (TActorIterator<AUnitBase> It(World); It; ++It)
+    {
+        AUnitBase* Unit = *It;
+        if (IsValid(Unit) && !Unit->IsHidden())
+        {
+            Start.Units.Add(MakeUnitStart(Unit));
+            DispatchJoin(Unit);
+        }
+    }
+
+    Participants.Reset();
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        if (ABuildingPlayerController* PC = Cast<ABuildingPlayerController>(It->Get()))
+        {
+            Participants.Add(PC);
+        }
+    }
+
+    BeginSession(Start);
+
+    for (const TWeakObjectPtr<ABuildingPlayerController>& Participant : Participants)
+    {
+        ABuildingPlayerController* PC = Participant.Get();
+        if (PC && !PC->IsLocalController())
+        {
+            PC->Client_StartLockstep(Start);
+        }
+    }
+
+    return true;
+}
+
+void UUnitLockstepSubsystem::BeginSession(const FLockstepStart& Start)
+{
+    if (!InitializeSpace())
+    {
+        return;
+    }
+
+    StepsPerSecond = FMath::Max(1, Start.StepsPerSecond);
+    StepsPerTurn = FMath::Max(1, Start.StepsPerTurn);
+    TurnDelay = FMath::Max(1, Start.TurnDelay);
+
+    Units.Reset();
+    UnitIds.Reset();
+    ReadyTurns.Reset();
+    LocalCommands.Reset();
+    PendingTurns.Reset();
+    OwnChecksums.Reset();
+    EarlyChecksums.Reset();
+
+    for (const FLockstepUnitStart& Entry : Start.Units)
+    {
+        AddUnit(Entry);
+    }
+
+    // Nobody could order anything for the first turns
+    for (int32 Turn = 0; Turn < TurnDelay; ++Turn)
+    {
+        FLockstepTurn Empty;
+        Empty.Turn = Turn;
+        ReadyTurns.Add(Turn, Empty);
+    }
+
+    CurrentTurn = 0;
+    StepInTurn = 0;
+    Accumulator = 0.0f;
+    FirstOpenTurn = TurnDelay;
+    LastChecksum = FLockstepChecksum();
+    bStalled = false;
+    bDesynced = false;
+    bRunning = true;
+
+    UE_LOG(LogTemp, Log, TEXT("Lockstep: Started with %d units, %d steps/s, %d steps per turn, delay %d turns"),
+           Units.Num(), StepsPerSecond, StepsPerTurn, TurnDelay);
+}
+
+bool UUnitLockstepSubsystem::InitializeSpace()
+{
+    const UToroidalWorldManager* Toroid = UToroidalWorldManager::Get(this);
+    if (Toroid && Toroid->IsFixedPointActive())
+    {
+        Space = Toroid->GetFixedSpace();
+        WorldCenter = Toroid->WorldCenter;
+        return true;
+    }
+
+    if (Toroid)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Lockstep: Toroidal world isn't in fixed point; units crossing the seam won't wrap in step"));
+    }
+
+    WorldCenter = FVector::ZeroVector;
+    if (!Space.Initialize(FallbackWorldSize, FallbackWorldSize))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Lockstep: FallbackWorldSize %f must be a power of two"), FallbackWorldSize);
+        return false;
+    }
+    return true;
+}
+
+void UUnitLockstepSubsystem::TakeOverActor(AUnitBase* Unit) const
+{
+    // The simulation owns the position from now on; the actor only shows it
+    Unit->bAllowCrowdSimulation = false;
+
+    if (AUnitController* UnitController = Cast<AUnitController>(Unit->GetController()))
+    {
+        UnitController->StopMovement();
+    }
+
+    if (UCharacterMovementComponent* Movement = Unit->GetCharacterMovement())
+    {
+        Movement->StopMovementImmediately();
+        Movement->DisableMovement();
+    }
+
+    // Every peer computes it; no need to send it
+    if (Unit->HasAuthority())
+    {
+        Unit->SetReplicateMovement(false);
+    }
+}
+
+FLockstepUnitStart UUnitLockstepSubsystem::MakeUnitStart(AUnitBase* Unit) const
+{
+    const FToroidalFixedCoordinate Position = Space.FromToroidal(Unit->GetActorLocation() - WorldCenter);
+
+    FLockstepUnitStart Entry;
+    Entry.Unit = Unit;
+    Entry.X = Position.X;
+    Entry.Y = Position.Y;
+    Entry.Z = Position.Z;
+    Entry.Speed = FMath::Max(1, Space.ToUnits(Unit->UnitMovementSpeed / StepsPerSecond));
+    return Entry;
+}
+
+void UUnitLockstepSubsystem::AddUnit(const FLockstepUnitStart& Entry)
+{
+    // Keep the slot even if the actor hasn't reached us; ids must line up.
+    // It attaches once it arrives (AttachActor).
+    const int32 UnitId = Units.Num();
+    FSimUnit& Unit = Units.AddDefaulted_GetRef();
+    Unit.Position = FToroidalFixedCoordinate(Entry.X, Entry.Y, Entry.Z);
+    Unit.PreviousPosition = Unit.Position;
+    Unit.Goal = Unit.Position;
+    Unit.Speed = Entry.Speed;
+
+    if (Entry.Unit)
+    {
+        AttachActor(Entry.Unit, UnitId);
+    }
+}
+
+void UUnitLockstepSubsystem::RemoveUnit(int32 UnitId)
+{
+    FSimUnit& Unit = Units[UnitId];
+    if (AUnitBase* Actor = Unit.Actor.Get())
+    {
+        UnitIds.Remove(FObjectKey(Actor));
+    }
+
+    // The slot stays so later ids don't shift
+    Unit.Actor = nullptr;
+    Unit.bActive = false;
+    Unit.bHasGoal = false;
+    Unit.Current = FLockstepCommand();
+    Unit.Queue.Empty();
+}
+
+void UUnitLockstepSubsystem::AttachActor(AUnitBase* Unit, int32 UnitId)
+{
+    if (!bRunning || !Unit || !Units.IsValidIndex(UnitId) || !Units[UnitId].bActive || Units[UnitId].Actor.IsValid())
+    {
+        return;
+    }
+
+    Units[UnitId].Actor = Unit;
+    UnitIds.Add(FObjectKey(Unit), UnitId);
+    TakeOverActor(Unit);
+}
+
+void UUnitLockstepSubsystem::DetachActor(AUnitBase* Unit)
+{
+    if (!bRunning || !Unit)
+    {
+        return;
+    }
+
+    // Presentation only; the sim slot stays until the leave is applied
+    int32 UnitId = INDEX_NONE;
+    if (UnitIds.RemoveAndCopyValue(FObjectKey(Unit), UnitId) && Units[UnitId].Actor.Get() == Unit)
+    {
+        Units[UnitId].Actor = nullptr;
+    }
+
+    // A unit reacquired from the pool before the next dispatch then joins afresh
+    if (DispatchedIds.RemoveAndCopyValue(FObjectKey(Unit), UnitId))
+    {
+        DispatchedUnits[UnitId] = nullptr;
+        PendingLeaves.Add(UnitId);
+    }
+
+    Unit->LockstepId = INDEX_NONE;
+}
+
+int32 UUnitLockstepSubsystem::GetUnitId(const AUnitBase* Unit) const
+{
+    const int32* UnitId = UnitIds.Find(FObjectKey(Unit));
+    return UnitId ? *UnitId : INDEX_NONE;
+}
+
+bool UUnitLockstepSubsystem::SubmitCommand(AUnitBase* Unit, const FUnitCommand& Command, bool bQueue)
+{
+    const int32 UnitId = GetUnitId(Unit);
+    if (!bRunning || UnitId == INDEX_NONE || !Command.IsValid())
+    {
+        return false;
+    }
+
+    // Targets go out as a location; other peers may not see the same actor
+    const AActor* Target = Command.TargetActor.Get();
+    const FVector Location = Target ? Target->GetActorLocation() : Command.TargetLocation;
+    const FToroidalFixedCoordinate FixedTarget = Space.FromToroidal(Location - WorldCenter);
+
+    FLockstepCommand& Submitted = LocalCommands.AddDefaulted_GetRef();
+    Submitted.UnitId = UnitId;
+    Submitted.CommandType = Command.CommandType;
+    Submitted.TargetX = FixedTarget.X;
+    Submitted.TargetY = FixedTarget.Y;
+    Submitted.TargetZ = FixedTarget.Z;
+    Submitted.Priority = Command.Priority;
+    Submitted.bQueued = bQueue;
+    return true;
+}
+
+void UUnitLockstepSubsystem::SendSubmission(int32 Turn)
+{
+    // Dedicated servers have no player to submit for
+    ABuildingPlayerController* PC = Cast<ABuildingPlayerController>(GEngine->GetFirstLocalPlayerController(GetWorld()));
+    if (!PC)
+    {
+        return;
+    }
+
+    FLockstepSubmission Submission;
+    Submission.Turn = Turn;
+    Submission.Checksum = LastChecksum;
+
+    const int32 NumCommands = FMath::Min(LocalCommands.Num(), MaxCommandsPerTurn);
+    Submission.Commands.Append(LocalCommands.GetData(), NumCommands);
+    LocalCommands.RemoveAt(0, NumCommands, EAllowShrinking::No);
+
+    PC->Server_SubmitLockstepCommands(Submission);
+}
+
+void UUnitLockstepSubsystem::ReceiveSubmission(ABuildingPlayerController* From, const FLockstepSubmission& Submission)
+{
+    if (!bRunning || !Participants.Contains(From))
+    {
+        return;
+    }
+
+    if (Submission.Turn < FirstOpenTurn || Submission.Turn > FirstOpenTurn + MaxTurnsAhead)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Lockstep: Dropped submission from %s for turn %d (open turn %d)"),
+               *From->GetName(), Submission.Turn, FirstOpenTurn);
+        return;
+    }
+
+    FPendingTurn& Pending = PendingTurns.FindOrAdd(Submission.Turn);
+    if (Pending.Submitted.Contains(From))
+    {
+        return;
+    }
+    Pending.Submitted.Add(From);
+
+    // Players only order their own team's units
+    const ACustomPlayerState* PlayerState = From->GetPlayerState<ACustomPlayerState>();
+    int32 NumRejected = 0;
+    for (const FLockstepCommand& Command : Submission.Commands)
+    {
+        const AUnitBase* Unit = DispatchedUnits.IsValidIndex(Command.UnitId) ? DispatchedUnits[Command.UnitId].Get() : nullptr;
+        if (Command.IsValid() && Unit && PlayerState && Unit->GetTeamId() == PlayerState->TeamID)
+        {
+            Pending.Commands.Add(Command);
+        }
+        else
+        {
+            ++NumRejected;
+        }
+    }
+
+    if (NumRejected > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Lockstep: Rejected %d commands from %s for turn %d"),
+               NumRejected, *From->GetName(), Submission.Turn);
+    }
+
+    // Our own player's state is ours by definition
+    if (!From->IsLocalController() && Submission.Checksum.Turn != INDEX_NONE)
+    {
+        FRemoteChecksum Remote;
+        Remote.Peer = From->GetName();
+        Remote.Checksum = Submission.Checksum;
+
+        if (Remote.Checksum.Turn >= CurrentTurn)
+        {
+            // They're ahead of us; compare once we get there
+            EarlyChecksums.Add(MoveTemp(Remote));
+        }
+        else
+        {
+            CompareChecksum(Remote);
+        }
+    }
+
+    TryDispatchTurns();
+}
+
+bool UUnitLockstepSubsystem::HasAllSubmissions(const FPendingTurn& Pending) const
+{
+    for (const TWeakObjectPtr<ABuildingPlayerController>& Participant : Participants)
+    {
+        if (Participant.IsValid() && !Pending.Submitted.Contains(Participant))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void UUnitLockstepSubsystem::TryDispatchTurns()
+{
+    Participants.RemoveAll([](const TWeakObjectPtr<ABuildingPlayerController>& Participant)
+    {
+        return !Participant.IsValid();
+    });
+
+    // Turns go out in order. With nobody left to wait for, empty turns keep
+    // the server's own simulation going.
+    while (FirstOpenTurn <= CurrentTurn + TurnDelay)
+    {
+        const FPendingTurn* Pending = PendingTurns.Find(FirstOpenTurn);
+        if (Participants.Num() > 0 && (!Pending || !HasAllSubmissions(*Pending)))
+        {
+            break;
+        }
+
+        FLockstepTurn Turn;
+        Turn.Turn = FirstOpenTurn;
+        CollectRosterChanges(Turn);
+        if (Pending)
+        {
+            Turn.Commands = Pending->Commands;
+        }
+        PendingTurns.Remove(FirstOpenTurn);
+        ++FirstOpenTurn;
+
+        for (const TWeakObjectPtr<ABuildingPlayerController>& Participant : Participants)
+        {
+            if (!Participant->IsLocalController())
+            {
+                Participant->Client_ReceiveLockstepTurn(Turn);
+            }
+        }
+        ReceiveTurn(Turn);
+    }
+}
+
+void UUnitLockstepSubsystem::CollectRosterChanges(FLockstepTurn& Turn)
+{
+    // Reported by the units themselves
+    Turn.Leaves.Append(PendingLeaves);
+    PendingLeaves.Reset();
+
+    // Gone or hidden without telling us
+    for (auto It = DispatchedIds.CreateIterator(); It; ++It)
+    {
+        AUnitBase* Unit = DispatchedUnits[It.Value()].Get();
+        if (!IsValid(Unit) || Unit->IsHidden())
+        {
+            Turn.Leaves.Add(It.Value());
+            DispatchedUnits[It.Value()] = nullptr;
+            if (Unit)
+            {
+                Unit->LockstepId = INDEX_NONE;
+            }
+            It.RemoveCurrent();
+        }
+    }
+
+    // Spawned, or out of the pool or a crowd, since the last turn
+    for (TActorIterator<AUnitBase> It(GetWorld()); It; ++It)
+    {
+        AUnitBase* Unit = *It;
+        if (IsValid(Unit) && !Unit->IsHidden() && !DispatchedIds.Contains(FObjectKey(Unit)))
+        {
+            Turn.Joins.Add(MakeUnitStart(Unit));
+            DispatchJoin(Unit);
+        }
+    }
+}
+
+int32 UUnitLockstepSubsystem::DispatchJoin(AUnitBase* Unit)
+{
+    // Ids are handed out in roster order, so every peer arrives at the same one.
+    // Replicated to clients so a late actor can find its slot.
+    const int32 UnitId = DispatchedUnits.Add(Unit);
+    DispatchedIds.Add(FObjectKey(Unit), UnitId);
+    Unit->LockstepId = UnitId;
+    return UnitId;
+}
+
+void UUnitLockstepSubsystem::ReceiveTurn(const FLockstepTurn& Turn)
+{
+    if (!bRunning || Turn.Turn < CurrentTurn)
+    {
+        return;
+    }
+
+    ReadyTurns.Add(Turn.Turn, Turn);
+}
+
+void UUnitLockstepSubsystem::ApplyTurn(const FLockstepTurn& Turn)
+{
+    for (const int32 UnitId : Turn.Leaves)
+    {
+        if (Units.IsValidIndex(UnitId))
+        {
+            RemoveUnit(UnitId);
+        }
+    }
+
+    for (const FLockstepUnitStart& Entry : Turn.Joins)
+    {
+        AddUnit(Entry);
+    }
+
+    for (const FLockstepCommand& Command : Turn.Commands)
+    {
+        if (Units.IsValidIndex(Command.UnitId) && Units[Command.UnitId].bActive)
+        {
+            ApplyCommand(Units[Command.UnitId], Command);
+        }
+    }
+}
+
+void UUnitLockstepSubsystem::ApplyCommand(FSimUnit& Unit, const FLockstepCommand& Command) const
+{
+    // Same rules as AUnitController::ExecuteCommand / QueueCommand
+    if (Command.bQueued)
+    {
+        if (!Unit.Current.IsValid())
+        {
+            StartCommand(Unit, Command);
+        }
+        else if (Command.Priority > Unit.Current.Priority)
+        {
+            Unit.Queue.Insert(Unit.Current, 0);
+            StartCommand(Unit, Command);
+        }
+        else if (Unit.Queue.Num() < MaxQueuedCommands)
+        {
+            Unit.Queue.Add(Command);
+        }
+        return;
+    }
+
+    if (Unit.Current.IsValid() && Command.Priority < Unit.Current.Priority)
+    {
+        if (Unit.Queue.Num() < MaxQueuedCommands)
+        {
+            Unit.Queue.Add(Command);
+        }
+        return;
+    }
+
+    Unit.Queue.Reset();
+    Unit.Current = FLockstepCommand();
+
+    if (Command.CommandType == EUnitCommandType::Patrol)
+    {
+        FLockstepCommand ReturnLeg = Command;
+        ReturnLeg.TargetX = Unit.Position.X;
+        ReturnLeg.TargetY = Unit.Position.Y;
+        ReturnLeg.TargetZ = Unit.Position.Z;
+        Unit.Queue.Add(ReturnLeg);
+    }
+
+    StartCommand(Unit, Command);
+}
+
+void UUnitLockstepSubsystem::StartCommand(FSimUnit& Unit, const FLockstepCommand& Command) const
+{
+    switch (Command.CommandType)
+    {
+        case EUnitCommandType::Move:
+        case EUnitCommandType::Patrol:
+        case EUnitCommandType::Attack:
+            // Height follows the ground on the actor; the simulation is flat
+            Unit.Current = Command;
+            Unit.Goal = FToroidalFixedCoordinate(Command.TargetX, Command.TargetY, Unit.Position.Z);
+            Unit.bHasGoal = true;
+            break;
+        case EUnitCommandType::Stop:
+            Unit.Queue.Reset();
+            Unit.Current = FLockstepCommand();
+            Unit.bHasGoal = false;
+            break;
+        default:
+            break;
+    }
+}
+
+void UUnitLockstepSubsystem::AdvanceCommands(FSimUnit& Unit) const
+{
+    // Patrol legs go round again
+    if (Unit.Current.CommandType == EUnitCommandType::Patrol && Unit.Queue.Num() < MaxQueuedCommands)
+    {
+        Unit.Queue.Add(Unit.Current);
+    }
+
+    Unit.Current = FLockstepCommand();
+    Unit.bHasGoal = false;
+
+    if (Unit.Queue.Num() > 0)
+    {
+        const FLockstepCommand Next = Unit.Queue[0];
+        Unit.Queue.RemoveAt(0);
+        StartCommand(Unit, Next);
+    }
+}
+
+void UUnitLockstepSubsystem::StepSimulation()
+{
+    for (FSimUnit& Unit : Units)
+    {
+        Unit.PreviousPosition = Unit.Position;
+        if (!Unit.bHasGoal)
+        {
+            continue;
+        }
+
+        const FIntVector Delta = Space.GetDelta(Unit.Position, Unit.Goal);
+        const uint64 DistanceSquared = static_cast<uint64>(static_cast<int64>(Delta.X) * Delta.X) +
+                                       static_cast<uint64>(static_cast<int64>(Delta.Y) * Delta.Y);
+        const int64 Speed = Unit.Speed;
+
+        if (DistanceSquared <= static_cast<uint64>(Speed * Speed))
+        {
+            Unit.Position.X = Unit.Goal.X;
+            Unit.Position.Y = Unit.Goal.Y;
+            AdvanceCommands(Unit);
+            continue;
+        }
+
+        // Integer division truncates toward zero on every platform
+        const int64 Distance = static_cast<int64>(IntegerSqrt(DistanceSquared));
+        const FIntVector Step(static_cast<int32>(Delta.X * Speed / Distance), static_cast<int32>(Delta.Y * Speed / Distance), 0);
+        Unit.Position = Space.Offset(Unit.Position, Step);
+    }
+}
+
+void UUnitLockstepSubsystem::FinishTurn()
+{
+    LastChecksum = ComputeChecksum(CurrentTurn);
+
+    if (GetWorld()->GetNetMode() != NM_Client)
+    {
+        OwnChecksums.Add(CurrentTurn, LastChecksum);
+        OwnChecksums.Remove(CurrentTurn - ChecksumHistory);
+
+        for (int32 i = EarlyChecksums.Num() - 1; i >= 0; --i)
+        {
+            if (EarlyChecksums[i].Checksum.Turn <= CurrentTurn)
+            {
+                CompareChecksum(EarlyChecksums[i]);
+                EarlyChecksums.RemoveAtSwap(i, 1, EAllowShrinking::No);
+            }
+        }
+    }
+
+    StepInTurn = 0;
+    ++CurrentTurn;
+}
+
+FLockstepChecksum UUnitLockstepSubsystem::ComputeChecksum(int32 Turn) const
+{
+    FLockstepChecksum Checksum;
+    Checksum.Turn = Turn;
+
+    TArray<uint32> Data;
+    const auto AddCommand = [&Data](const FLockstepCommand& Command)
+    {
+        Data.Add(static_cast<uint32>(Command.CommandType));
+        Data.Add(Command.TargetX);
+        Data.Add(Command.TargetY);
+        Data.Add(static_cast<uint32>(Command.TargetZ));
+        Data.Add(static_cast<uint32>(Command.Priority));
+    };
+
+    // Orders too: queues that differ only diverge positions later
+    Data.Reserve(Units.Num() * 13);
+    for (const FSimUnit& Unit : Units)
+    {
+        Data.Add(Unit.bActive ? 1u : 0u);
+        Data.Add(Unit.Position.X);
+        Data.Add(Unit.Position.Y);
+        Data.Add(static_cast<uint32>(Unit.Position.Z));
+        Data.Add(Unit.bHasGoal ? 1u : 0u);
+        Data.Add(Unit.Goal.X);
+        Data.Add(Unit.Goal.Y);
+        AddCommand(Unit.Current);
+        Data.Add(static_cast<uint32>(Unit.Queue.Num()));
+        for (const FLockstepCommand& Queued : Unit.Queue)
+        {
+            AddCommand(Queued);
+        }
+    }
+    Checksum.Units = FCrc::MemCrc32(Data.GetData(), Data.Num() * sizeof(uint32));
+
+    // Player ids match on every peer; array order may not
+    Data.Reset();
+    if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+    {
+        TArray<const ACustomPlayerState*> PlayerStates;
+        for (const APlayerState* PlayerState : GameState->PlayerArray)
+        {
+            if (const ACustomPlayerState* CustomState = Cast<ACustomPlayerState>(PlayerState))
+            {
+                PlayerStates.Add(CustomState);
+            }
+        }
+        PlayerStates.Sort([](const ACustomPlayerState& A, const ACustomPlayerState& B)
+        {
+            return A.GetPlayerId() < B.GetPlayerId();
+        });
+
+        for (const ACustomPlayerState* PlayerState : PlayerStates)
+        {
+            Data.Add(static_cast<uint32>(PlayerState->GetPlayerId()));
+            for (const FResource& Resource : PlayerState->PlayerResources)
+            {
+                // FName indices differ between processes; hash the text
+                Data.Add(FCrc::StrCrc32(*Resource.ResourceName.ToString()));
+                Data.Add(static_cast<uint32>(Resource.ResourceAmount));
+            }
+        }
+    }
+    Checksum.Resources = FCrc::MemCrc32(Data.GetData(), Data.Num() * sizeof(uint32));
+
+    return Checksum;
+}
+
+void UUnitLockstepSubsystem::CompareChecksum(const FRemoteChecksum& Remote)
+{
+    const FLockstepChecksum* Own = OwnChecksums.Find(Remote.Checksum.Turn);
+    if (!Own)
+    {
+        return;
+    }
+
+    if (Own->Units != Remote.Checksum.Units)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Lockstep: %s desynced at turn %d (units %08x, server %08x)"),
+               *Remote.Peer, Remote.Checksum.Turn, Remote.Checksum.Units, Own->Units);
+
+        if (!bDesynced)
+        {
+            bDesynced = true;
+            OnDesync.Broadcast(Remote.Checksum.Turn);
+        }
+    }
+    else if (Own->Resources != Remote.Checksum.Resources)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Lockstep: %s resources differ at turn %d (replication may still be catching up)"),
+               *Remote.Peer, Remote.Checksum.Turn);
+    }
+}
+
+void UUnitLockstepSubsystem::UpdatePresentation(float Alpha) const
+{
+    for (const FSimUnit& Unit : Units)
+    {
+        AUnitBase* Actor = Unit.Actor.Get();
+        if (!Actor)
+        {
+            continue;
+        }
+
+        // Interpolate in fixed point so the result is already wrapped onto the map
+        const FIntVector Delta = Space.GetDelta(Unit.PreviousPosition, Unit.Position);
+        const FToroidalFixedCoordinate Shown = Space.Offset(Unit.PreviousPosition,
+            FIntVector(FMath::RoundToInt(Delta.X * Alpha), FMath::RoundToInt(Delta.Y * Alpha), 0));
+
+        FVector Location = WorldCenter + Space.ToToroidal(Shown);
+        Location.Z = Actor->GetActorLocation().Z;
+
+        const FVector StepVector = Space.GetDeltaVector(Unit.PreviousPosition, Unit.Position);
+        const FRotator Rotation = StepVector.IsNearlyZero() ? Actor->GetActorRotation() : FRotator(0.0f, StepVector.Rotation().Yaw, 0.0f);
+        Actor->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+        // Drives the walk animation; movement itself is disabled
+        if (UCharacterMovementComponent* Movement = Actor->GetCharacterMovement())
+        {
+            Movement->Velocity = StepVector * StepsPerSecond;
+        }
+
+        if (Actor->GetIsMoving() != Unit.bHasGoal)
+        {
+            Actor->SetIsMoving(Unit.bHasGoal);
+        }
+    }
+}
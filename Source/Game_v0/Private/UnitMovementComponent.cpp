@@ -0,0 +1,56 @@
+#include "UnitMovementComponent.h"
+#include "UnitAvoidanceSubsystem.h"
+#include "Engine/World.h"
+
+UUnitMovementComponent::UUnitMovementComponent()
+{
+    // Engine RVO would fight with ours
+    bUseRVOAvoidance = false;
+}
+
+void UUnitMovementComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (UUnitAvoidanceSubsystem* Avoidance = GetWorld()->GetSubsystem<UUnitAvoidanceSubsystem>())
+    {
+        Avoidance->RegisterAgent(this);
+    }
+}
+
+void UUnitMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UUnitAvoidanceSubsystem* Avoidance = GetWorld()->GetSubsystem<UUnitAvoidanceSubsystem>())
+    {
+        Avoidance->UnregisterAgent(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UUnitMovementComponent::CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration)
+{
+    Super::CalcVelocity(DeltaTime, Friction, bFluid, BrakingDeceleration);
+
+    // With neither input (direct movement) nor a requested move (path
+    // following) the unit is braking to a stop. It prefers to stand still,
+    // so it isn't steered and the others just avoid it.
+    const bool bBraking = Acceleration.IsNearlyZero() && !bHasRequestedVelocity;
+    PreferredVelocity = bBraking ? FVector::ZeroVector : FVector(Velocity.X, Velocity.Y, 0.0f);
+
+    // The result is from the last pass, one frame behind, like engine RVO.
+    if (!bUseUnitAvoidance || PreferredVelocity.IsNearlyZero() || GFrameCounter - AvoidanceFrame > 1)
+    {
+        return;
+    }
+
+    const FVector Steered = AvoidanceVelocity.GetClampedToMaxSize2D(GetMaxSpeed());
+    Velocity.X = Steered.X;
+    Velocity.Y = Steered.Y;
+}
+
+void UUnitMovementComponent::SetAvoidanceVelocity(const FVector& InVelocity)
+{
+    AvoidanceVelocity = InVelocity;
+    AvoidanceFrame = GFrameCounter;
+}
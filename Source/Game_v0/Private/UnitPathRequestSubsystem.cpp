@@ -0,0 +1,191 @@
+#include "UnitPathRequestSubsystem.h"
+#include "UnitController.h"
+#include "NavigationSystem.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Unit Path Requests"), STAT_UnitPathRequests, STATGROUP_Game);
+
+bool UUnitPathRequestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUnitPathRequestSubsystem::Deinitialize()
+{
+    // Late results find nothing in flight and are dropped
+    Queue.Empty();
+    InFlight.Empty();
+
+    Super::Deinitialize();
+}
+
+TStatId UUnitPathRequestSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitPathRequestSubsystem, STATGROUP_Tickables);
+}
+
+uint32 UUnitPathRequestSubsystem::RequestPath(AUnitController* Controller, const FVector& Start, const FVector& Goal)
+{
+    FPathRequest& Request = Queue.AddDefaulted_GetRef();
+    Request.Controller = Controller;
+    Request.RequestId = NextRequestId++;
+    Request.Start = Start;
+    Request.Goal = Goal;
+
+    // 0 means "no request" to controllers
+    if (NextRequestId == 0)
+    {
+        NextRequestId = 1;
+    }
+    return Request.RequestId;
+}
+
+void UUnitPathRequestSubsystem::Tick(float DeltaTime)
+{
+    if (Queue.Num() == 0)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_UnitPathRequests);
+
+    // Merge requests by start and goal cell, in queue order
+    const auto ToCell = [this](const FVector& Location)
+    {
+        return FIntVector(FMath::FloorToInt(Location.X / ShareCellSize), FMath::FloorToInt(Location.Y / ShareCellSize),
+                          FMath::FloorToInt(Location.Z / ShareCellSize));
+    };
+
+    TArray<FPathRequestGroup> Groups;
+    TMap<TPair<FIntVector, FIntVector>, int32> GroupIndices;
+    int32 NumTaken = 0;
+    for (; NumTaken < Queue.Num(); ++NumTaken)
+    {
+        FPathRequest& Request = Queue[NumTaken];
+
+        // Gone, or re-ordered since; only the latest request counts
+        const AUnitController* Controller = Request.Controller.Get();
+        if (!Controller || Controller->GetPendingPathRequestId() != Request.RequestId)
+        {
+            continue;
+        }
+
+        const TPair<FIntVector, FIntVector> Key(ToCell(Request.Start), ToCell(Request.Goal));
+        if (const int32* GroupIndex = GroupIndices.Find(Key))
+        {
+            Groups[*GroupIndex].Members.Add(MoveTemp(Request));
+            continue;
+        }
+
+        if (Groups.Num() == MaxQueriesPerTick)
+        {
+            break;
+        }
+        GroupIndices.Add(Key, Groups.Num());
+        Groups.AddDefaulted_GetRef().Members.Add(MoveTemp(Request));
+    }
+    Queue.RemoveAt(0, NumTaken, EAllowShrinking::No);
+
+    int32 NumShared = 0;
+    for (FPathRequestGroup& Group : Groups)
+    {
+        NumShared += Group.Members.Num() - 1;
+        StartQuery(MoveTemp(Group));
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("UnitPathRequests: %d queries for %d requests, %d still queued"),
+           Groups.Num(), Groups.Num() + NumShared, Queue.Num());
+}
+
+bool UUnitPathRequestSubsystem::StartQuery(FPathRequestGroup&& Group)
+{
+    const FPathRequest& Lead = Group.Members[0];
+    AUnitController* Controller = Lead.Controller.Get();
+    UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+    const FNavAgentProperties& AgentProps = Controller->GetNavAgentPropertiesRef();
+    const ANavigationData* NavData = NavSys ? NavSys->GetNavDataForProps(AgentProps, Lead.Start) : nullptr;
+    if (!NavData)
+    {
+        for (const FPathRequest& Request : Group.Members)
+        {
+            Finish(Request, nullptr);
+        }
+        return false;
+    }
+
+    // Goals onto the navmesh, as AAIController::MoveTo would
+    for (FPathRequest& Request : Group.Members)
+    {
+        FNavLocation NavGoal;
+        if (NavSys->ProjectPointToNavigation(Request.Goal, NavGoal, INVALID_NAVEXTENT, NavData))
+        {
+            Request.Goal = NavGoal.Location;
+        }
+    }
+
+    FSharedConstNavQueryFilter Filter = UNavigationQueryFilter::GetQueryFilter(*NavData, Controller, Controller->GetDefaultNavigationFilterClass());
+    FPathFindingQuery Query(Controller, *NavData, Lead.Start, Lead.Goal, Filter);
+    Query.SetAllowPartialPaths(true);
+
+    const uint32 QueryId = NavSys->FindPathAsync(AgentProps, Query,
+        FNavPathQueryDelegate::CreateUObject(this, &UUnitPathRequestSubsystem::OnQueryFinished));
+    if (QueryId == INVALID_NAVQUERYID)
+    {
+        for (const FPathRequest& Request : Group.Members)
+        {
+            Finish(Request, nullptr);
+        }
+        return false;
+    }
+
+    InFlight.Add(QueryId, MoveTemp(Group));
+    return true;
+}
+
+void UUnitPathRequestSubsystem::OnQueryFinished(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+    FPathRequestGroup Group;
+    if (!InFlight.RemoveAndCopyValue(QueryId, Group))
+    {
+        return;
+    }
+
+    const bool bFound = Result == ENavigationQueryResult::Success && Path.IsValid() && Path->IsValid();
+    for (int32 i = 0; i < Group.Members.Num(); ++i)
+    {
+        if (!bFound)
+        {
+            Finish(Group.Members[i], nullptr);
+        }
+        else
+        {
+            Finish(Group.Members[i], i == 0 ? Path : MakeMemberPath(Path, Group.Members[i]));
+        }
+    }
+}
+
+FNavPathSharedPtr UUnitPathRequestSubsystem::MakeMemberPath(const FNavPathSharedPtr& SharedPath, const FPathRequest& Request) const
+{
+    // Ends are within a share cell of the lead's, so the corridor in between still holds
+    FNavPathSharedPtr MemberPath = MakeShared<FNavigationPath, ESPMode::ThreadSafe>();
+    TArray<FNavPathPoint>& Points = MemberPath->GetPathPoints();
+    Points = SharedPath->GetPathPoints();
+    Points[0].Location = Request.Start;
+    Points.Last().Location = Request.Goal;
+
+    MemberPath->SetNavigationDataUsed(SharedPath->GetNavigationDataUsed());
+    MemberPath->SetIsPartial(SharedPath->IsPartial());
+    MemberPath->MarkReady();
+    return MemberPath;
+}
+
+void UUnitPathRequestSubsystem::Finish(const FPathRequest& Request, FNavPathSharedPtr Path)
+{
+    if (AUnitController* Controller = Request.Controller.Get())
+    {
+        Controller->OnPathRequestFinished(Request.RequestId, MoveTemp(Path));
+    }
+}
@@ -0,0 +1,116 @@
+#include "UnitPoolSubsystem.h"
+#include "Engine/World.h"
+
+bool UUnitPoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUnitPoolSubsystem::Deinitialize()
+{
+    // Pooled actors die with the world; just drop the references
+    Pools.Empty();
+
+    Super::Deinitialize();
+}
+
+void UUnitPoolSubsystem::Prewarm(TSubclassOf<AUnitBase> UnitClass, int32 Count)
+{
+    if (!UnitClass)
+    {
+        return;
+    }
+
+    FUnitPoolEntry& Pool = Pools.FindOrAdd(UnitClass);
+    const int32 Target = FMath::Min(Count, MaxPooledPerClass);
+    const int32 NumToSpawn = Target - Pool.Units.Num();
+
+    for (int32 i = 0; i < NumToSpawn; ++i)
+    {
+        AUnitBase* Unit = SpawnUnit(UnitClass, FTransform::Identity, 0, GetDefault<AUnitBase>(UnitClass)->GetUnitSex());
+        if (!Unit)
+        {
+            break;
+        }
+
+        Unit->ResetForPool();
+        Pool.Units.Add(Unit);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("UnitPool: %d %s units ready"), Pool.Units.Num(), *UnitClass->GetName());
+}
+
+AUnitBase* UUnitPoolSubsystem::AcquireUnit(TSubclassOf<AUnitBase> UnitClass, const FTransform& Transform, int32 TeamId, EUnitSex Sex,
+                                           AUnitSelectionManager* SelectionManager)
+{
+    UClass* Class = UnitClass ? UnitClass.Get() : AUnitBase::StaticClass();
+
+    if (FUnitPoolEntry* Pool = Pools.Find(Class))
+    {
+        while (Pool->Units.Num() > 0)
+        {
+            AUnitBase* Unit = Pool->Units.Pop(EAllowShrinking::No);
+            if (IsValid(Unit))
+            {
+                Unit->ReinitializeFromPool(Transform, TeamId, Sex, SelectionManager);
+                return Unit;
+            }
+        }
+    }
+
+    // Pool ran dry: pay for a fresh one
+    AUnitBase* Unit = SpawnUnit(Class, Transform, TeamId, Sex);
+    if (Unit && SelectionManager)
+    {
+        Unit->InitializeUnit(TeamId, SelectionManager);
+    }
+    return Unit;
+}
+
+void UUnitPoolSubsystem::ReleaseUnit(AUnitBase* Unit)
+{
+    if (!IsValid(Unit) || Unit->IsPooled())
+    {
+        return;
+    }
+
+    FUnitPoolEntry& Pool = Pools.FindOrAdd(Unit->GetClass());
+    if (Pool.Units.Num() >= MaxPooledPerClass)
+    {
+        Unit->Destroy();
+        return;
+    }
+
+    Unit->ResetForPool();
+    Pool.Units.Add(Unit);
+}
+
+int32 UUnitPoolSubsystem::GetNumPooled(TSubclassOf<AUnitBase> UnitClass) const
+{
+    const FUnitPoolEntry* Pool = Pools.Find(UnitClass);
+    return Pool ? Pool->Units.Num() : 0;
+}
+
+AUnitBase* UUnitPoolSubsystem::SpawnUnit(UClass* UnitClass, const FTransform& Transform, int32 TeamId, EUnitSex Sex)
+{
+    // Deferred so sex (which picks the mesh) is set before BeginPlay
+    AUnitBase* Unit = GetWorld()->SpawnActorDeferred<AUnitBase>(UnitClass, Transform, nullptr, nullptr,
+                                                                ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+    if (!Unit)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("UnitPool: Failed to spawn %s"), *GetNameSafe(UnitClass));
+        return nullptr;
+    }
+
+    Unit->SetTeamId(TeamId);
+    Unit->SetUnitSex(Sex);
+    Unit->FinishSpawning(Transform);
+
+    if (!Unit->GetController())
+    {
+        Unit->SpawnDefaultController();
+    }
+
+    return Unit;
+}
@@ -1,6 +1,9 @@
 #include "UnitSelectionManager.h"
 #include "UnitBase.h"
 #include "UnitController.h"
+#include "UnitFlowField.h"
+#include "UnitLockstepSubsystem.h"
+#include "Toroid.h"
 #include "GameFramework/PlayerController.h"
 
 AUnitSelectionManager::AUnitSelectionManager()
@@ -102,7 +105,7 @@ void AUnitSelectionManager::DeselectAll()
     UE_LOG(LogTemp, Log, TEXT("SelectionManager: Deselected all units"));
 }
 
-void AUnitSelectionManager::IssueCommand(const FUnitCommand& Command)
+void AUnitSelectionManager::IssueCommand(const FUnitCommand& Command, bool bQueue)
 {
     if (SelectedUnits.Num() == 0)
     {
@@ -110,25 +113,57 @@ void AUnitSelectionManager::IssueCommand(const FUnitCommand& Command)
         return;
     }
 
-    UE_LOG(LogTemp, Log, TEXT("SelectionManager: Issuing command to %d units: %s"), 
+    UE_LOG(LogTemp, Log, TEXT("SelectionManager: %s command to %d units: %s"), bQueue ? TEXT("Queueing") : TEXT("Issuing"),
            SelectedUnits.Num(), *Command.ToString());
 
+    // In lockstep orders go to every peer instead of straight to the unit
+    UUnitLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UUnitLockstepSubsystem>();
+    const bool bLockstep = Lockstep && Lockstep->IsRunning();
+
+    const auto Dispatch = [bQueue, Lockstep](AUnitBase* Unit, const FUnitCommand& UnitCommand)
+    {
+        if (Lockstep && Lockstep->SubmitCommand(Unit, UnitCommand, bQueue))
+        {
+            return;
+        }
+
+        AUnitController* UnitController = Cast<AUnitController>(Unit->GetController());
+        if (!UnitController)
+        {
+            return;
+        }
+
+        if (bQueue)
+        {
+            UnitController->QueueCommand(UnitCommand);
+        }
+        else
+        {
+            UnitController->ExecuteCommand(UnitCommand);
+        }
+    };
+
     // Handle movement commands with formation
     if (Command.CommandType == EUnitCommandType::Move && SelectedUnits.Num() > 1)
     {
-        TArray<FVector> FormationPositions = CalculateFormationPositions(Command.TargetLocation, SelectedUnits.Num());
+        const FVector Facing = GetGroupFacing(Command.TargetLocation);
+        const TArray<FVector> FormationPositions = AssignFormationSlots(Command.TargetLocation,
+            CalculateFormationPositions(Command.TargetLocation, SelectedUnits.Num(), Facing));
+
+        // Queued legs start later from wherever each unit is then; no shared field for those
+        if (!bQueue && !bLockstep && bUseFlowFieldForGroups && SelectedUnits.Num() >= FlowFieldMinGroupSize &&
+            IssueFlowFieldMove(Command.TargetLocation, FormationPositions))
+        {
+            return;
+        }
         
         for (int32 i = 0; i < SelectedUnits.Num() && i < FormationPositions.Num(); i++)
         {
             if (SelectedUnits[i])
             {
-                AUnitController* UnitController = Cast<AUnitController>(SelectedUnits[i]->GetController());
-                if (UnitController)
-                {
-                    FUnitCommand FormationCommand = Command;
-                    FormationCommand.TargetLocation = FormationPositions[i];
-                    UnitController->ExecuteCommand(FormationCommand);
-                }
+                FUnitCommand FormationCommand = Command;
+                FormationCommand.TargetLocation = FormationPositions[i];
+                Dispatch(SelectedUnits[i], FormationCommand);
             }
         }
     }
@@ -139,20 +174,16 @@ void AUnitSelectionManager::IssueCommand(const FUnitCommand& Command)
         {
             if (Unit)
             {
-                AUnitController* UnitController = Cast<AUnitController>(Unit->GetController());
-                if (UnitController)
-                {
-                    UnitController->ExecuteCommand(Command);
-                }
+                Dispatch(Unit, Command);
             }
         }
     }
 }
 
-void AUnitSelectionManager::IssueMoveCommand(FVector TargetLocation)
+void AUnitSelectionManager::IssueMoveCommand(FVector TargetLocation, bool bQueue)
 {
     FUnitCommand MoveCommand(EUnitCommandType::Move, TargetLocation);
-    IssueCommand(MoveCommand);
+    IssueCommand(MoveCommand, bQueue);
 }
 
 void AUnitSelectionManager::IssueStopCommand()
@@ -182,7 +213,45 @@ void AUnitSelectionManager::ValidateSelectedUnits()
     });
 }
 
-TArray<FVector> AUnitSelectionManager::CalculateFormationPositions(FVector CenterLocation, int32 UnitCount)
+bool AUnitSelectionManager::IssueFlowFieldMove(const FVector& TargetLocation, const TArray<FVector>& FormationPositions)
+{
+    TArray<FVector> StartLocations;
+    for (const AUnitBase* Unit : SelectedUnits)
+    {
+        if (Unit)
+        {
+            StartLocations.Add(Unit->GetActorLocation());
+        }
+    }
+
+    // The goal region covers the whole formation, so every unit leaves the field next to its slot
+    float GoalRadius = FlowFieldCellSize;
+    for (const FVector& Position : FormationPositions)
+    {
+        GoalRadius = FMath::Max(GoalRadius, static_cast<float>(FVector::Dist2D(Position, TargetLocation)) + FlowFieldCellSize);
+    }
+
+    TSharedPtr<FUnitFlowField> Field = MakeShared<FUnitFlowField>();
+    if (!Field->Build(GetWorld(), TargetLocation, GoalRadius, StartLocations, FlowFieldCellSize))
+    {
+        return false;
+    }
+
+    for (int32 i = 0; i < SelectedUnits.Num() && i < FormationPositions.Num(); i++)
+    {
+        AUnitController* UnitController = SelectedUnits[i] ? Cast<AUnitController>(SelectedUnits[i]->GetController()) : nullptr;
+        if (UnitController)
+        {
+            // Replaces whatever the unit had lined up; runs as its Move order
+            UnitController->FollowFlowField(Field, FormationPositions[i]);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("SelectionManager: %d units sharing a flow field of %d cells"), SelectedUnits.Num(), Field->GetNumCells());
+    return true;
+}
+
+TArray<FVector> AUnitSelectionManager::CalculateFormationPositions(FVector CenterLocation, int32 UnitCount, const FVector& Facing)
 {
     TArray<FVector> Positions;
     
@@ -195,26 +264,198 @@ TArray<FVector> AUnitSelectionManager::CalculateFormationPositions(FVector Cente
         return Positions;
     }
 
-    // Simple grid formation
-    float Spacing = 150.0f; // Distance between units
-    int32 UnitsPerRow = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(UnitCount)));
-    
-    int32 CurrentUnit = 0;
-    for (int32 Row = 0; Row < UnitsPerRow && CurrentUnit < UnitCount; Row++)
+    TArray<FVector2D> Offsets;
+    GetFormationOffsets(UnitCount, Offsets);
+
+    // Formation X runs along the direction of travel
+    const FVector Forward = Facing.GetSafeNormal2D().IsNearlyZero() ? FVector::ForwardVector : Facing.GetSafeNormal2D();
+    const FVector Right(-Forward.Y, Forward.X, 0.0f);
+
+    Positions.Reserve(UnitCount);
+    for (const FVector2D& Offset : Offsets)
     {
-        int32 UnitsInThisRow = FMath::Min(UnitsPerRow, UnitCount - CurrentUnit);
-        float RowOffset = (UnitsInThisRow - 1) * Spacing * 0.5f;
-        
-        for (int32 Col = 0; Col < UnitsInThisRow; Col++)
+        Positions.Add(CenterLocation + Forward * Offset.X + Right * Offset.Y);
+    }
+
+    return Positions;
+}
+
+void AUnitSelectionManager::GetFormationOffsets(int32 UnitCount, TArray<FVector2D>& OutOffsets) const
+{
+    OutOffsets.Reset(UnitCount);
+
+    // Fill ranks front to back, each centred on the target
+    const auto AddRank = [this, &OutOffsets](int32 RankIndex, int32 Count, float Forward)
+    {
+        const float HalfWidth = (Count - 1) * FormationSpacing * 0.5f;
+        for (int32 Col = 0; Col < Count; Col++)
         {
-            FVector Position = CenterLocation;
-            Position.X += (Col * Spacing) - RowOffset;
-            Position.Y += Row * Spacing;
-            
-            Positions.Add(Position);
-            CurrentUnit++;  
+            OutOffsets.Add(FVector2D(Forward - RankIndex * FormationSpacing, Col * FormationSpacing - HalfWidth));
+        }
+    };
+
+    switch (FormationShape)
+    {
+        case EUnitFormationShape::Line:
+        {
+            const int32 Width = FMath::Min(UnitCount, MaxLineWidth);
+            const int32 NumRanks = FMath::DivideAndRoundUp(UnitCount, Width);
+            const float Front = (NumRanks - 1) * FormationSpacing * 0.5f;
+            for (int32 Rank = 0; Rank < NumRanks; Rank++)
+            {
+                AddRank(Rank, FMath::Min(Width, UnitCount - Rank * Width), Front);
+            }
+            break;
+        }
+        case EUnitFormationShape::Wedge:
+        {
+            // Point at the target, each rank behind one wider on both sides
+            for (int32 Rank = 0; OutOffsets.Num() < UnitCount; Rank++)
+            {
+                const int32 Count = FMath::Min(2 * Rank + 1, UnitCount - OutOffsets.Num());
+                if (Count == 2 * Rank + 1)
+                {
+                    AddRank(Rank, Count, 0.0f);
+                }
+                else
+                {
+                    // Last, partial rank: fill the wings in from the outside
+                    for (int32 i = 0; i < Count; i++)
+                    {
+                        const int32 Side = (i % 2 == 0) ? 1 : -1;
+                        const int32 Step = Rank - i / 2;
+                        OutOffsets.Add(FVector2D(-Rank * FormationSpacing, Side * Step * FormationSpacing));
+                    }
+                }
+            }
+            break;
+        }
+        case EUnitFormationShape::Box:
+        default:
+        {
+            const int32 Width = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(UnitCount)));
+            const int32 NumRanks = FMath::DivideAndRoundUp(UnitCount, Width);
+            const float Front = (NumRanks - 1) * FormationSpacing * 0.5f;
+            for (int32 Rank = 0; Rank < NumRanks; Rank++)
+            {
+                AddRank(Rank, FMath::Min(Width, UnitCount - Rank * Width), Front);
+            }
+            break;
         }
     }
+}
 
-    return Positions;
-}
\ No newline at end of file
+FVector AUnitSelectionManager::GetGroupFacing(const FVector& TargetLocation) const
+{
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+
+    FVector Centroid = FVector::ZeroVector;
+    int32 NumUnits = 0;
+    for (const AUnitBase* Unit : SelectedUnits)
+    {
+        if (Unit)
+        {
+            // Offsets from the target, so the average is seam safe
+            Centroid += ToroidalWorld ? ToroidalWorld->GetToroidalDelta(TargetLocation, Unit->GetActorLocation())
+                                      : Unit->GetActorLocation() - TargetLocation;
+            NumUnits++;
+        }
+    }
+
+    return NumUnits > 0 ? (-Centroid / NumUnits).GetSafeNormal2D() : FVector::ZeroVector;
+}
+
+TArray<FVector> AUnitSelectionManager::AssignFormationSlots(const FVector& TargetLocation, const TArray<FVector>& Slots) const
+{
+    const int32 NumUnits = FMath::Min(SelectedUnits.Num(), Slots.Num());
+    if (NumUnits <= 1)
+    {
+        return Slots;
+    }
+
+    // Everything as 2D offsets from the target
+    const UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this);
+    TArray<FVector2D> UnitOffsets;
+    TArray<FVector2D> SlotOffsets;
+    UnitOffsets.Reserve(NumUnits);
+    SlotOffsets.Reserve(NumUnits);
+    for (int32 i = 0; i < NumUnits; i++)
+    {
+        const FVector UnitLocation = SelectedUnits[i] ? SelectedUnits[i]->GetActorLocation() : TargetLocation;
+        UnitOffsets.Add(FVector2D(ToroidalWorld ? ToroidalWorld->GetToroidalDelta(TargetLocation, UnitLocation) : UnitLocation - TargetLocation));
+        SlotOffsets.Add(FVector2D(Slots[i] - TargetLocation));
+    }
+
+    const auto Cost = [&UnitOffsets, &SlotOffsets](int32 Unit, int32 Slot)
+    {
+        return FVector2D::Distance(UnitOffsets[Unit], SlotOffsets[Slot]);
+    };
+
+    // Greedy: closest unit/slot pairs first
+    struct FSlotPair
+    {
+        float Cost;
+        int32 Unit;
+        int32 Slot;
+    };
+    TArray<FSlotPair> Pairs;
+    Pairs.Reserve(NumUnits * NumUnits);
+    for (int32 Unit = 0; Unit < NumUnits; Unit++)
+    {
+        for (int32 Slot = 0; Slot < NumUnits; Slot++)
+        {
+            Pairs.Add({ static_cast<float>(Cost(Unit, Slot)), Unit, Slot });
+        }
+    }
+    Pairs.Sort([](const FSlotPair& A, const FSlotPair& B) { return A.Cost < B.Cost; });
+
+    TArray<int32> SlotOfUnit;
+    SlotOfUnit.Init(INDEX_NONE, NumUnits);
+    TBitArray<> SlotTaken(false, NumUnits);
+    int32 NumAssigned = 0;
+    for (const FSlotPair& Pair : Pairs)
+    {
+        if (SlotOfUnit[Pair.Unit] == INDEX_NONE && !SlotTaken[Pair.Slot])
+        {
+            SlotOfUnit[Pair.Unit] = Pair.Slot;
+            SlotTaken[Pair.Slot] = true;
+            if (++NumAssigned == NumUnits)
+            {
+                break;
+            }
+        }
+    }
+
+    // Greedy leaves the last units with long, crossing walks; swapping any
+    // pair that shortens the total untangles them (shortest total never crosses)
+    for (int32 Pass = 0; Pass < FormationRefinePasses; Pass++)
+    {
+        bool bImproved = false;
+        for (int32 A = 0; A < NumUnits; A++)
+        {
+            for (int32 B = A + 1; B < NumUnits; B++)
+            {
+                const double Current = Cost(A, SlotOfUnit[A]) + Cost(B, SlotOfUnit[B]);
+                const double Swapped = Cost(A, SlotOfUnit[B]) + Cost(B, SlotOfUnit[A]);
+                if (Swapped < Current - KINDA_SMALL_NUMBER)
+                {
+                    Swap(SlotOfUnit[A], SlotOfUnit[B]);
+                    bImproved = true;
+                }
+            }
+        }
+
+        if (!bImproved)
+        {
+            break;
+        }
+    }
+
+    TArray<FVector> Assigned;
+    Assigned.Reserve(Slots.Num());
+    for (int32 Unit = 0; Unit < NumUnits; Unit++)
+    {
+        Assigned.Add(Slots[SlotOfUnit[Unit]]);
+    }
+    return Assigned;
+}
@@ -0,0 +1,25 @@
+#include "UnitSkeletalMeshComponent.h"
+#include "UnitAnimationBudgetSubsystem.h"
+#include "Engine/World.h"
+
+void UUnitSkeletalMeshComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // Not there on a dedicated server
+    AnimationBudget = GetWorld()->GetSubsystem<UUnitAnimationBudgetSubsystem>();
+}
+
+void UUnitSkeletalMeshComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    UUnitAnimationBudgetSubsystem* Budget = AnimationBudget.Get();
+    if (!Budget)
+    {
+        Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+        return;
+    }
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    Budget->AddMeasuredTime(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+}
@@ -0,0 +1,116 @@
+#include "UnitTickSubsystem.h"
+#include "UnitBase.h"
+#include "UnitController.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Unit Tick"), STAT_UnitTick, STATGROUP_Game);
+
+namespace
+{
+    // Below this ground speed (cm/s) a unit that isn't ordered to move is idle
+    constexpr float IdleSpeedThreshold = 10.0f;
+}
+
+bool UUnitTickSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UUnitTickSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUnitTickSubsystem, STATGROUP_Tickables);
+}
+
+void UUnitTickSubsystem::RegisterUnit(AUnitBase* Unit)
+{
+    if (!Unit)
+    {
+        return;
+    }
+
+    RegisteredUnits.Add(Unit);
+
+    // Placed in the level already walking, or ordered before BeginPlay
+    if (Unit->GetIsMoving())
+    {
+        ActivateUnit(Unit);
+    }
+}
+
+void UUnitTickSubsystem::UnregisterUnit(AUnitBase* Unit)
+{
+    RegisteredUnits.Remove(Unit);
+
+    if (const int32* Index = ActiveIndices.Find(Unit))
+    {
+        RemoveActiveAt(*Index);
+    }
+}
+
+void UUnitTickSubsystem::ActivateUnit(AUnitBase* Unit)
+{
+    if (!Unit || !RegisteredUnits.Contains(Unit))
+    {
+        return;
+    }
+
+    // Controller may have changed since the unit was last active
+    AUnitController* Controller = Cast<AUnitController>(Unit->GetController());
+
+    if (const int32* Index = ActiveIndices.Find(Unit))
+    {
+        ActiveControllers[*Index] = Controller;
+        return;
+    }
+
+    ActiveIndices.Add(Unit, ActiveUnits.Add(Unit));
+    ActiveControllers.Add(Controller);
+}
+
+void UUnitTickSubsystem::RemoveActiveAt(int32 Index)
+{
+    ActiveIndices.Remove(ActiveUnits[Index]);
+
+    ActiveUnits.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    ActiveControllers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+    // The last unit moved into the hole
+    if (Index < ActiveUnits.Num())
+    {
+        ActiveIndices.Add(ActiveUnits[Index], Index);
+    }
+}
+
+void UUnitTickSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_UnitTick);
+
+    ++FrameCounter;
+    const uint32 Slices = static_cast<uint32>(FMath::Max(AnimationStateSlices, 1));
+
+    // Backwards, so units going idle can swap out of the array
+    for (int32 i = ActiveUnits.Num() - 1; i >= 0; --i)
+    {
+        AUnitBase* Unit = ActiveUnits[i];
+        AUnitController* Controller = ActiveControllers[i];
+
+        if (IsValid(Controller))
+        {
+            Controller->TickMovement(DeltaTime);
+        }
+
+        const bool bIdle = !Unit->GetIsMoving() && Unit->GetVelocity().SizeSquared2D() < FMath::Square(IdleSpeedThreshold);
+
+        // Last update before going idle always runs so speed settles at zero
+        if (bIdle || (static_cast<uint32>(i) + FrameCounter) % Slices == 0)
+        {
+            Unit->UpdateAnimationState();
+        }
+
+        if (bIdle)
+        {
+            RemoveActiveAt(i);
+        }
+    }
+}
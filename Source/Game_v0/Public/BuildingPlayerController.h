@@ -7,6 +7,7 @@
 #include "BuildingPlacementComponent.h"
 #include "buildings/BuildingBase.h"
 #include "resource.h"
+#include "UnitLockstepSubsystem.h"
 #include "BuildingPlayerController.generated.h"
 
 class UInputMappingContext;
@@ -113,12 +114,23 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Unit Selection")
     void DeselectAllUnits();
     
+    // bQueue appends the move to each unit's orders instead of replacing them
     UFUNCTION(BlueprintCallable, Category = "Unit Selection")
-    void CommandSelectedUnits(FVector TargetLocation);
+    void CommandSelectedUnits(FVector TargetLocation, bool bQueue = false);
 
     UFUNCTION()
     void OnPlayerResourcesChanged(const TArray<FResource>& UpdatedResources);
 
+    // Lockstep turn exchange (see UUnitLockstepSubsystem)
+    UFUNCTION(Server, Reliable)
+    void Server_SubmitLockstepCommands(const FLockstepSubmission& Submission);
+
+    UFUNCTION(Client, Reliable)
+    void Client_StartLockstep(const FLockstepStart& Start);
+
+    UFUNCTION(Client, Reliable)
+    void Client_ReceiveLockstepTurn(const FLockstepTurn& Turn);
+
 private:
     // Camera dragging
     bool bIsDraggingCamera;
@@ -8,6 +8,7 @@
 #include "resource.h"
 #include "Net/UnrealNetwork.h"
 #include "Race_base.h"
+#include "PlayerRoster.h"
 #include "Blueprint/UserWidget.h"
 #include "CustomPlayerState.generated.h"
 
@@ -18,6 +19,8 @@ class AUnitBase;
 // Delegates
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnResourcesChanged);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnRaceSelected);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRosterUnitChanged, AUnitBase*, Unit);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRosterBuildingChanged, ABuildingBase*, Building);
 
 /**
  * Custom PlayerState for storing team, race, and resource info.
@@ -36,7 +39,7 @@ public:
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-    /** Team number: 1 or 2 */
+    /** Team number: 1 or 2. Set through SetTeamID once playing, so rosters follow. */
     UPROPERTY(Replicated, BlueprintReadWrite)
     int32 TeamID;
 
@@ -52,8 +55,12 @@ public:
     UPROPERTY(Replicated, BlueprintReadWrite)
     TSubclassOf<URace_base> PlayerRace;
 
+    /** Units and buildings this player owns; only changes are sent */
     UPROPERTY(Replicated)
-    TArray<AUnitBase*> PlayerUnits;
+    FPlayerUnitList PlayerUnits;
+
+    UPROPERTY(Replicated)
+    FPlayerBuildingList PlayerBuildings;
 
     UPROPERTY()
     TSubclassOf<URace_base> PlayerRaceClass;
@@ -74,6 +81,19 @@ public:
     UPROPERTY(BlueprintAssignable)
     FOnRaceSelected OnRaceSelected;
 
+    /** Events: Roster changes, on the server and on every client */
+    UPROPERTY(BlueprintAssignable)
+    FOnRosterUnitChanged OnUnitAdded;
+
+    UPROPERTY(BlueprintAssignable)
+    FOnRosterUnitChanged OnUnitRemoved;
+
+    UPROPERTY(BlueprintAssignable)
+    FOnRosterBuildingChanged OnBuildingAdded;
+
+    UPROPERTY(BlueprintAssignable)
+    FOnRosterBuildingChanged OnBuildingRemoved;
+
     /** Widget class for resource display */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI")
     TSubclassOf<UResourceDisplayWidget> ResourceDisplayWidgetClass;
@@ -114,7 +134,18 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Resources")
     TArray<FName> GetUniqueResourceNames() const;
 
-    // Unit management methods
+    /** First player state on the given team, if any */
+    static ACustomPlayerState* FindForTeam(const UObject* WorldContextObject, int32 InTeamID);
+
+    /** Change team and re-roster units (server only) */
+    UFUNCTION(BlueprintCallable)
+    void SetTeamID(int32 NewTeamID);
+
+    /** List units that exist already, e.g. placed in the level before this player joined (server only) */
+    UFUNCTION(BlueprintCallable)
+    void AdoptTeamUnits();
+
+    // Unit management methods (server only)
     UFUNCTION(BlueprintCallable)
     void RegisterUnit(AUnitBase* Unit);
 
@@ -122,7 +153,7 @@ public:
     void UnregisterUnit(AUnitBase* Unit);
 
     UFUNCTION(BlueprintPure)
-    TArray<AUnitBase*> GetPlayerUnits() const { return PlayerUnits; }
+    TArray<AUnitBase*> GetPlayerUnits() const { return PlayerUnits.GetUnits(); }
 
     UFUNCTION(BlueprintPure)
     int32 GetUnitCount() const { return PlayerUnits.Num(); }
@@ -130,6 +161,19 @@ public:
     UFUNCTION(BlueprintPure)
     TArray<AUnitBase*> GetUnitsOfTeam(int32 InTeamID) const;
 
+    // Building management methods (server only)
+    UFUNCTION(BlueprintCallable)
+    void RegisterBuilding(ABuildingBase* Building);
+
+    UFUNCTION(BlueprintCallable)
+    void UnregisterBuilding(ABuildingBase* Building);
+
+    UFUNCTION(BlueprintPure)
+    TArray<ABuildingBase*> GetPlayerBuildings() const { return PlayerBuildings.GetBuildings(); }
+
+    UFUNCTION(BlueprintPure)
+    int32 GetBuildingCount() const { return PlayerBuildings.Num(); }
+
 
 
 protected:
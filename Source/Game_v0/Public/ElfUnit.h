@@ -15,7 +15,7 @@ class GAME_V0_API AElfUnit : public AUnitBase
 	GENERATED_BODY()
 
 public:
-	AElfUnit();
+	AElfUnit(const FObjectInitializer& ObjectInitializer);
 
 
 	// Female mesh override
@@ -26,6 +26,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elf Appearance", meta = (AllowedClasses = "AnimBlueprint"))
 	TSoftClassPtr<UAnimInstance> FemaleAnimBP;
 
+	// Vertex animation versions of the elf meshes (baked from ABP_Unit/ABP_FemaleElf) for distant crowds
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elf Appearance|Crowd")
+	FUnitCrowdVisual MaleCrowdVisual;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elf Appearance|Crowd")
+	FUnitCrowdVisual FemaleCrowdVisual;
+
+	virtual const FUnitCrowdVisual* GetCrowdVisual(EUnitSex Sex) const override;
+
+	virtual void GetAssetsToPreload(TArray<FSoftObjectPath>& OutPaths) const override;
+
+	// A pooled elf may come back as the other sex
+	virtual void ReinitializeFromPool(const FTransform& Transform, int32 InTeamId, EUnitSex InSex, AUnitSelectionManager* InSelectionManager) override;
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void OnConstruction(const FTransform& Transform) override;
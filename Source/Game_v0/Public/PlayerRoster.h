@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "UObject/ObjectKey.h"
+#include "PlayerRoster.generated.h"
+
+class AUnitBase;
+class ABuildingBase;
+class ACustomPlayerState;
+struct FPlayerUnitList;
+struct FPlayerBuildingList;
+
+/**
+ * Rosters of what a player owns, replicated as fast arrays: each add or
+ * remove sends only that entry instead of the whole list. Clients hear about
+ * changes through the owning player state's OnUnitAdded/OnUnitRemoved and
+ * OnBuildingAdded/OnBuildingRemoved. An entry can arrive before its actor
+ * does; it is announced once the actor resolves.
+ *
+ * Only the server edits rosters.
+ */
+USTRUCT()
+struct GAME_V0_API FPlayerUnitEntry : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    AUnitBase* Unit = nullptr;
+
+    // Client: OnUnitAdded went out for this entry
+    bool bAnnounced = false;
+
+    void PreReplicatedRemove(const FPlayerUnitList& InArraySerializer);
+    void PostReplicatedAdd(const FPlayerUnitList& InArraySerializer);
+    void PostReplicatedChange(const FPlayerUnitList& InArraySerializer);
+};
+
+USTRUCT()
+struct GAME_V0_API FPlayerUnitList : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FPlayerUnitEntry> Items;
+
+    // Player state holding this roster; receives the client callbacks
+    UPROPERTY(NotReplicated)
+    ACustomPlayerState* Owner = nullptr;
+
+    // False if already listed / not listed
+    bool Add(AUnitBase* Unit);
+    bool Remove(AUnitBase* Unit);
+
+    bool Contains(const AUnitBase* Unit) const;
+    int32 Num() const { return Items.Num(); }
+    TArray<AUnitBase*> GetUnits() const;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FPlayerUnitEntry, FPlayerUnitList>(Items, DeltaParms, *this);
+    }
+
+private:
+    // Server: slot of each unit, for O(1) removal
+    TMap<FObjectKey, int32> Indices;
+};
+
+template<>
+struct TStructOpsTypeTraits<FPlayerUnitList> : public TStructOpsTypeTraitsBase2<FPlayerUnitList>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
+
+USTRUCT()
+struct GAME_V0_API FPlayerBuildingEntry : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    ABuildingBase* Building = nullptr;
+
+    // Client: OnBuildingAdded went out for this entry
+    bool bAnnounced = false;
+
+    void PreReplicatedRemove(const FPlayerBuildingList& InArraySerializer);
+    void PostReplicatedAdd(const FPlayerBuildingList& InArraySerializer);
+    void PostReplicatedChange(const FPlayerBuildingList& InArraySerializer);
+};
+
+USTRUCT()
+struct GAME_V0_API FPlayerBuildingList : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FPlayerBuildingEntry> Items;
+
+    // Player state holding this roster; receives the client callbacks
+    UPROPERTY(NotReplicated)
+    ACustomPlayerState* Owner = nullptr;
+
+    // False if already listed / not listed
+    bool Add(ABuildingBase* Building);
+    bool Remove(ABuildingBase* Building);
+
+    bool Contains(const ABuildingBase* Building) const;
+    int32 Num() const { return Items.Num(); }
+    TArray<ABuildingBase*> GetBuildings() const;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FPlayerBuildingEntry, FPlayerBuildingList>(Items, DeltaParms, *this);
+    }
+
+private:
+    // Server: slot of each building, for O(1) removal
+    TMap<FObjectKey, int32> Indices;
+};
+
+template<>
+struct TStructOpsTypeTraits<FPlayerBuildingList> : public TStructOpsTypeTraitsBase2<FPlayerBuildingList>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
@@ -10,6 +10,8 @@
 #include "buildings/BuildingBase.h"
 #include "Race_base.generated.h"
 
+class AUnitBase;
+
 
 /**
  * 
@@ -53,6 +55,9 @@ class GAME_V0_API URace_base : public UObject
 
 	TArray<TSubclassOf<ABuildingBase>> GetAvailableBuildings(){return AvailableBuildings;};
 
+	// Units this race fields; their assets are preloaded on race selection
+	const TArray<TSubclassOf<AUnitBase>>& GetUnitClasses() const {return UnitClasses;};
+
 	UFUNCTION(BlueprintCallable, Category = "Race")
 	FName GetRaceName(){return RaceName;};
 	
@@ -111,6 +116,9 @@ class GAME_V0_API URace_base : public UObject
 	UPROPERTY(EditDefaultsOnly, Category="Race")
 	TArray<TSubclassOf<ABuildingBase>> AvailableBuildings;
 
+	UPROPERTY(EditDefaultsOnly, Category="Race")
+	TArray<TSubclassOf<AUnitBase>> UnitClasses;
+
 	UPROPERTY(EditDefaultsOnly, Category="Recource")
 	TArray<FResource> AllResources;//Reserved don't modify
 	
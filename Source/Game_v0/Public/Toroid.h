@@ -3,8 +3,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
 #include "Engine/World.h"
+#include "ToroidalSpatialGrid.h"
+#include "ToroidalObjectStore.h"
+#include "ToroidalFixedPoint.h"
 #include "Toroid.generated.h"
+
+class UInstancedStaticMeshComponent;
 //Not an actual toroid - discontinous edge connection
 
 
@@ -43,28 +49,103 @@ struct FToroidalCoordinate
     }
 };
 
+// How wrapped images of an object are represented
+UENUM(BlueprintType)
+enum class EToroidalGhostMode : uint8
+{
+    // Full template copy of the actor (ticks, controllers and all)
+    ActorCopy   UMETA(DisplayName = "Actor Copy"),
+    // Render-only proxies mirroring the original's mesh components
+    MeshProxy   UMETA(DisplayName = "Mesh Proxy")
+};
+
+// Part of a collision query that stays on the canonical map between two seams
+struct FToroidalQueryPiece
+{
+    // Toroidal-to-world shifted so the piece lies on the map
+    FVector Start = FVector::ZeroVector;
+    FVector End = FVector::ZeroVector;
+
+    // Fraction of the whole query covered before and by this piece
+    float StartTime = 0.0f;
+    float EndTime = 0.0f;
+};
+
+/**
+ * Running counters of the wrapping work done, for profiling and benchmarks
+ */
 USTRUCT(BlueprintType)
-struct FWrappedObject
+struct FToroidalWorldStats
 {
     GENERATED_BODY()
 
-    UPROPERTY()
-    TWeakObjectPtr<AActor> OriginalActor;
+    // Dirty objects re-evaluated by the wrap tick
+    UPROPERTY(BlueprintReadOnly, Category = "Toroidal World")
+    int32 ObjectsEvaluated = 0;
 
-    UPROPERTY()
-    TArray<TWeakObjectPtr<AActor>> WrappedInstances;
+    // Actor ghosts spawned because the pool was empty
+    UPROPERTY(BlueprintReadOnly, Category = "Toroidal World")
+    int32 GhostsSpawned = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Toroidal World")
+    int32 GhostsReused = 0;
+
+    // Released ghosts that didn't fit in the pool
+    UPROPERTY(BlueprintReadOnly, Category = "Toroidal World")
+    int32 GhostsDestroyed = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Toroidal World")
+    int32 ProxiesAcquired = 0;
+};
+
+// Result of evaluating one dirty object, applied on the game thread
+struct FToroidalWrapCommand
+{
+    // Dense index into the manager's tracked objects; only good until the
+    // first command is applied, since applying can unregister actors
+    int32 Index = INDEX_NONE;
+
+    // Stable handle of the same object, re-resolved when applying
+    FToroidalHandle Handle;
+
+    // Where the actor was when it got picked up
+    FVector CurrentLocation = FVector::ZeroVector;
 
-    UPROPERTY()
     FToroidalCoordinate CanonicalPosition;
+    FVector NormalizedWorldPosition = FVector::ZeroVector;
 
-    FWrappedObject()
-    {
-    }
+    // The actor crossed a seam and has to be moved back inside
+    bool bRelocate = false;
 
-    FWrappedObject(AActor* Actor, const FToroidalCoordinate& Position)
-        : OriginalActor(Actor), CanonicalPosition(Position)
-    {
-    }
+    EToroidalEdgeFlags EdgeFlags = EToroidalEdgeFlags::None;
+    TArray<FVector> WrappedPositions;
+};
+
+/**
+ * Idle wrapped instances of one actor class, kept around for reuse
+ */
+USTRUCT()
+struct FToroidalGhostPool
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<TWeakObjectPtr<AActor>> FreeGhosts;
+};
+
+/**
+ * Instanced mesh drawing every proxy image of one static mesh
+ */
+USTRUCT()
+struct FToroidalProxyBatch
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UInstancedStaticMeshComponent* Component = nullptr;
+
+    // Hidden instances ready for reuse
+    TArray<int32> FreeInstances;
 };
 
 /**
@@ -79,8 +160,12 @@ class GAME_V0_API UToroidalWorldManager : public UActorComponent
 public:
     UToroidalWorldManager();
 
+    // Active manager of the given object's world, if there is one
+    static UToroidalWorldManager* Get(const UObject* WorldContextObject);
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 public:
@@ -99,9 +184,38 @@ public:
     UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World")
     FVector WorldCenter;
 
-    // Objects to track for wrapping
-    UPROPERTY()
-    TArray<FWrappedObject> TrackedObjects;
+    // Edge length of a spatial grid cell. Roughly the most common query radius works best.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World|Queries", meta = (ClampMin = "1.0"))
+    float SpatialCellSize;
+
+    // Mesh proxies keep gameplay on the single original actor and only draw its images
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World")
+    EToroidalGhostMode GhostMode;
+
+    // Idle wrapped instances kept per actor class; extra ones are destroyed
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World", meta = (ClampMin = "0"))
+    int32 MaxPooledGhostsPerClass;
+
+    // Only materialize wrapped images the local camera can (nearly) see.
+    // Edge status is still tracked for everything; only ghosts are skipped.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World|Culling")
+    bool bCullGhostsToView;
+
+    // Added around the camera's ground footprint so ghosts exist before they scroll in
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World|Culling", meta = (ClampMin = "0.0"))
+    float ViewCullMargin;
+
+    // Cap for view rays that don't hit the ground (camera looking at the horizon)
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World|Culling", meta = (ClampMin = "1.0"))
+    float MaxViewDistance;
+
+    // Set up the integer fixed point space (GetFixedSpace) for systems that
+    // store fixed coordinates, such as lockstep: exact wrapping and
+    // bit-identical results on every machine. The float query API (deltas,
+    // distances, normalizing) is unaffected. Needs power-of-two world sizes;
+    // otherwise a warning is logged and the space stays invalid.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World")
+    bool bUseFixedPointCoordinates;
 
     // Objects that should be excluded from wrapping (like terrain, etc.)
     UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Toroidal World")
@@ -127,6 +241,11 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Toroidal World")
     void UpdateActorWrapping(AActor* Actor);
 
+    // Re-evaluate an actor next tick. Movement is picked up automatically;
+    // use this for visual changes the wrapped images should mirror.
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World")
+    void MarkActorDirty(AActor* Actor);
+
     // Camera management
     UFUNCTION(BlueprintCallable, Category = "Toroidal World")
     void WrapCameraPosition(AActor* CameraActor);
@@ -138,6 +257,51 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Toroidal World")
     FVector GetToroidalDirection(const FVector& From, const FVector& To) const;
 
+    // Shortest (unnormalized) offset from From to To across the seams
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World")
+    FVector GetToroidalDelta(const FVector& From, const FVector& To) const;
+
+    // If the shortest route from From to To leaves the map, where to hand off:
+    // OutExit lies just inside the seam crossed first, OutEntry is the matching
+    // point just inside the opposite edge. Inset keeps both on the map.
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World")
+    bool GetSeamCrossing(const FVector& From, const FVector& To, float Inset, FVector& OutExit, FVector& OutEntry) const;
+
+    // Seam aware collision queries. A query leaving the map is split at the
+    // seams into pieces on the canonical map, and shapes reaching over an edge
+    // are repeated on the far side, so hits are always the real actors.
+    // Hit Time/Distance refer to the whole query; locations are in the frame
+    // of the piece that hit (on the map, or just past an edge for shapes).
+    bool ToroidalLineTraceSingle(FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+                                 const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam) const;
+
+    bool ToroidalLineTraceMulti(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+                                const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam) const;
+
+    bool ToroidalSweepSingle(FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel TraceChannel,
+                             const FCollisionShape& Shape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam) const;
+
+    bool ToroidalOverlapMulti(TArray<FOverlapResult>& OutOverlaps, const FVector& Position, const FQuat& Rotation, ECollisionChannel TraceChannel,
+                              const FCollisionShape& Shape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam) const;
+
+    // Split Start -> End at the seams
+    void SplitQueryAtSeams(const FVector& Start, const FVector& End, TArray<FToroidalQueryPiece>& OutPieces) const;
+
+    // World offsets (always including zero) at which a box on the map also
+    // has to be tested because it reaches over an edge
+    void GetSeamImageOffsets(const FBox& Bounds, TArray<FVector, TInlineAllocator<4>>& OutOffsets) const;
+
+    // Spatial queries over tracked actors (seam aware)
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World|Queries")
+    TArray<AActor*> GetActorsInRadius(const FVector& Center, float Radius) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World|Queries")
+    TArray<AActor*> GetActorsInBox(const FVector& Center, const FVector2D& HalfExtents) const;
+
+    // Up to K closest actors, nearest first. MaxRadius <= 0 searches the whole world.
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World|Queries")
+    TArray<AActor*> GetKNearestActors(const FVector& Center, int32 K, float MaxRadius = 0.0f) const;
+
     // Utility functions
     UFUNCTION(BlueprintCallable, Category = "Toroidal World")
     bool IsActorNearEdge(AActor* Actor) const;
@@ -145,17 +309,121 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Toroidal World")
     TArray<FVector> GetWrappedPositions(const FVector& OriginalPosition) const;
 
+    // Same as above for an already normalized position, appending to OutPositions
+    void ComputeWrappedPositions(const FToroidalCoordinate& NormalizedPosition, TArray<FVector>& OutPositions) const;
+
+    EToroidalEdgeFlags GetEdgeFlags(const FToroidalCoordinate& NormalizedPosition) const;
+
+    // Whether a wrapped image at this world position should be materialized
+    bool IsPositionInView(const FVector& WorldPosition) const;
+
     UFUNCTION(BlueprintCallable, Category = "Toroidal World")
     void SetWorldDimensions(float Width, float Height);
 
+    UFUNCTION(BlueprintPure, Category = "Toroidal World")
+    int32 GetNumTrackedActors() const { return TrackedObjects.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Toroidal World")
+    FToroidalWorldStats GetStats() const { return Stats; }
+
+    UFUNCTION(BlueprintCallable, Category = "Toroidal World")
+    void ResetStats() { Stats = FToroidalWorldStats(); }
+
+    // Re-evaluate everything that moved since the last call. This is the whole
+    // per-frame work of the component; exposed for headless benchmarks.
+    void ProcessDirtyObjects();
+
+    // Stable handle of a tracked actor (unset if the actor is not tracked)
+    FToroidalHandle GetActorHandle(AActor* Actor) const;
+
+    // Fixed point coordinates (valid once the space is set up, see bUseFixedPointCoordinates)
+    bool IsFixedPointActive() const { return bUseFixedPointCoordinates && FixedSpace.IsValid(); }
+    const FToroidalFixedSpace& GetFixedSpace() const { return FixedSpace; }
+    FToroidalFixedCoordinate WorldToFixed(const FVector& WorldPosition) const;
+    FVector FixedToWorld(const FToroidalFixedCoordinate& Coordinate) const;
+
 private:
     // Internal functions
-    void CreateWrappedInstances(FWrappedObject& WrappedObject);
-    void UpdateWrappedInstances(FWrappedObject& WrappedObject);
-    void CleanupWrappedInstances(FWrappedObject& WrappedObject);
+    // All of these take a dense index into TrackedObjects
+    void CreateWrappedInstances(int32 Index);
+    void UpdateWrappedInstances(int32 Index);
+    void CleanupWrappedInstances(int32 Index);
+    void SyncWrappedInstances(int32 Index, const TArray<FVector>& WrappedPositions);
     bool ShouldExcludeActor(AActor* Actor) const;
     AActor* CreateWrappedInstance(AActor* OriginalActor, const FVector& Position);
 
-    // Cache for performance
-    TMap<AActor*, int32> ActorToIndexMap;
+    // Ghost pooling
+    AActor* AcquireGhost(AActor* OriginalActor, const FVector& Position);
+    void ReleaseGhost(AActor* Ghost);
+    void CopyGhostAppearance(AActor* OriginalActor, AActor* Ghost) const;
+
+    UPROPERTY()
+    TMap<UClass*, FToroidalGhostPool> GhostPools;
+
+    // Mesh proxies
+    void SyncProxyInstances(int32 Index, const TArray<FVector>& WrappedPositions);
+    FToroidalGhostProxy AcquireProxy(AActor* OriginalActor);
+    void ReleaseProxy(FToroidalGhostProxy& Proxy);
+    void UpdateProxy(FToroidalGhostProxy& Proxy, const FVector& Offset);
+    bool AcquireProxyInstance(UStaticMeshComponent* Source, FToroidalProxyElement& Element);
+    bool AcquireSkeletalProxyFor(USkeletalMeshComponent* Source, FToroidalProxyElement& Element);
+    void ReleaseProxyInstance(FToroidalProxyElement& Element);
+    USkeletalMeshComponent* AcquireSkeletalProxy();
+
+    UPROPERTY()
+    TMap<UStaticMesh*, FToroidalProxyBatch> ProxyBatches;
+
+    UPROPERTY()
+    TArray<USkeletalMeshComponent*> FreeSkeletalProxies;
+
+    void RebuildSpatialGrid();
+
+    // Wrap evaluation. Building is pure math and safe on worker threads;
+    // applying touches actors and must happen on the game thread.
+    void BuildWrapCommand(const FToroidalCoordinate& CanonicalPosition, FToroidalWrapCommand& Command) const;
+    void ApplyWrapCommand(const FToroidalWrapCommand& Command);
+
+    // Dirty tracking
+    void MarkIndexDirty(int32 Index);
+    void OnTrackedTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+    UFUNCTION()
+    void OnTrackedActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+    // Tracked objects that moved since the last tick. May hold stale handles;
+    // DirtyFlags in the store is the source of truth.
+    TArray<FToroidalHandle> DirtyHandles;
+
+    // Per-tick buffers, kept to avoid reallocating
+    TArray<FToroidalWrapCommand> WrapCommands;
+    TArray<float> ScratchX;
+    TArray<float> ScratchY;
+
+    // Set while we move actors ourselves so those moves don't re-dirty them
+    bool bApplyingWrap = false;
+
+    FToroidalWorldStats Stats;
+
+    void RebuildFixedSpace();
+
+    FToroidalFixedSpace FixedSpace;
+
+    // View culling
+    void UpdateViewBounds();
+    bool ComputeViewBounds(FBox2D& OutBounds) const;
+
+    // Expanded ground footprint of the local camera in toroidal space, where
+    // the camera really is (not wrapped). Invalid when there is no local camera.
+    FBox2D ViewBounds;
+
+    // View the current set of ghosts was laid out for
+    FBox2D EvaluatedViewBounds;
+
+    // Objects to track for wrapping
+    FToroidalObjectStore TrackedObjects;
+
+    TMap<AActor*, FToroidalHandle> ActorToHandle;
+
+    // Tracked actors bucketed by normalized position
+    FToroidalSpatialGrid SpatialGrid;
 };
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ToroidalBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless stress benchmark for UToroidalWorldManager.
+ *
+ * Spawns N tracked actors in a throwaway world, random-walks them across the
+ * seams and writes per-frame wrap tick time, ghost counters and memory as CSV.
+ *
+ * UnrealEditor-Cmd Game_v0.uproject -run=ToroidalBenchmark -nullrhi -unattended
+ *     [-Actors=2000] [-Frames=600] [-Seed=1] [-Speed=600] [-GhostMode=MeshProxy|ActorCopy]
+ *     [-Output=Saved/Benchmarks/Toroid.csv] [-MaxP99Ms=0]
+ *
+ * With -MaxP99Ms set, returns non-zero when the p99 wrap tick exceeds it.
+ */
+UCLASS()
+class GAME_V0_API UToroidalBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UToroidalBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Position on the torus in integer fixed point.
+ *
+ * X and Y are scaled so that 2^32 equals the world size along that axis.
+ * Unsigned overflow therefore is the wrap: any arithmetic stays on the map
+ * without a single compare, and reinterpreting as int32 gives the centered
+ * [-Size/2, Size/2) form. Z does not wrap and is stored in the space's
+ * common unit (see FToroidalFixedSpace).
+ */
+struct FToroidalFixedCoordinate
+{
+    uint32 X = 0;
+    uint32 Y = 0;
+    int32 Z = 0;
+
+    FToroidalFixedCoordinate()
+    {
+    }
+
+    FToroidalFixedCoordinate(uint32 InX, uint32 InY, int32 InZ)
+        : X(InX), Y(InY), Z(InZ)
+    {
+    }
+
+    bool operator==(const FToroidalFixedCoordinate& Other) const
+    {
+        return X == Other.X && Y == Other.Y && Z == Other.Z;
+    }
+
+    bool operator!=(const FToroidalFixedCoordinate& Other) const
+    {
+        return !(*this == Other);
+    }
+};
+
+/**
+ * Conversion and math for FToroidalFixedCoordinate in a world whose width
+ * and height are powers of two (in cm).
+ *
+ * Deltas come out in a common unit, 2^32 of which span the larger world
+ * axis, so mixed-size axes can still be combined into distances. All
+ * integer results are bit-identical on every machine; conversions from
+ * float are exact scalings by powers of two followed by rounding.
+ * Z shares the common unit and is clamped to +-a quarter of the larger world
+ * size, so Z deltas fit in 32 bits like X and Y.
+ */
+struct GAME_V0_API FToroidalFixedSpace
+{
+public:
+    // Both sizes must be powers of two between 2 and 2^30 cm. Returns false
+    // (leaving the space invalid) otherwise.
+    bool Initialize(float WorldWidth, float WorldHeight);
+
+    bool IsValid() const { return BitsX > 0 && BitsY > 0; }
+
+    static bool IsValidWorldSize(float Size);
+
+    // Toroidal space (world position minus WorldCenter) <-> fixed point.
+    // Any input wraps onto the map.
+    FToroidalFixedCoordinate FromToroidal(const FVector& ToroidalPosition) const;
+    FVector ToToroidal(const FToroidalFixedCoordinate& Coordinate) const;
+
+    // Shortest signed offset From -> To in common units: one subtract per
+    // axis, with overflow picking the short way round
+    FIntVector GetDelta(const FToroidalFixedCoordinate& From, const FToroidalFixedCoordinate& To) const
+    {
+        return FIntVector(
+            static_cast<int32>(To.X - From.X) >> ShiftX,
+            static_cast<int32>(To.Y - From.Y) >> ShiftY,
+            To.Z - From.Z);
+    }
+
+    // Move by a delta in common units; the result wraps by itself
+    FToroidalFixedCoordinate Offset(const FToroidalFixedCoordinate& Coordinate, const FIntVector& Delta) const
+    {
+        return FToroidalFixedCoordinate(
+            Coordinate.X + (static_cast<uint32>(Delta.X) << ShiftX),
+            Coordinate.Y + (static_cast<uint32>(Delta.Y) << ShiftY),
+            Coordinate.Z + Delta.Z);
+    }
+
+    // Squared distance in common units, exact. Each axis contributes at most
+    // 2^62, so the sum needs the full unsigned 64 bits (near-antipodal X and
+    // Y alone already pass INT64_MAX).
+    uint64 GetDistanceSquared(const FToroidalFixedCoordinate& From, const FToroidalFixedCoordinate& To) const
+    {
+        const FIntVector Delta = GetDelta(From, To);
+        return static_cast<uint64>(static_cast<int64>(Delta.X) * Delta.X)
+            + static_cast<uint64>(static_cast<int64>(Delta.Y) * Delta.Y)
+            + static_cast<uint64>(static_cast<int64>(Delta.Z) * Delta.Z);
+    }
+
+    // Delta and distance converted to cm
+    FVector GetDeltaVector(const FToroidalFixedCoordinate& From, const FToroidalFixedCoordinate& To) const;
+    float GetDistance(const FToroidalFixedCoordinate& From, const FToroidalFixedCoordinate& To) const;
+
+    // Size of one common unit in cm
+    double GetUnitSize() const { return UnitSize; }
+
+    int32 ToUnits(double Centimeters) const { return static_cast<int32>(FMath::RoundToDouble(Centimeters / UnitSize)); }
+    double ToCentimeters(int64 Units) const { return static_cast<double>(Units) * UnitSize; }
+
+private:
+    // log2 of the world size per axis
+    int32 BitsX = 0;
+    int32 BitsY = 0;
+
+    // Left shift from common units to an axis' native scale (0 for the larger axis)
+    int32 ShiftX = 0;
+    int32 ShiftY = 0;
+
+    // Fixed units per cm along each axis
+    double ScaleX = 1.0;
+    double ScaleY = 1.0;
+
+    double UnitSize = 1.0;
+};
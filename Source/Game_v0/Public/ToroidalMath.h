@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Branch-free toroidal math, scalar and batched.
+ *
+ * Batched functions work on structure-of-arrays float data in toroidal space
+ * (world position minus the manager's WorldCenter, see WorldToToroidal) and
+ * process four positions per step using the engine's vector registers.
+ * Wrapping is done as V - Size * floor(V / Size + 0.5), which maps into
+ * [-Size/2, Size/2) without loops or per-axis branches.
+ * Z never wraps.
+ */
+struct GAME_V0_API FToroidalMath
+{
+    // Wrap a single coordinate into [-Size/2, Size/2)
+    static FORCEINLINE float Wrap(float Value, float Size)
+    {
+        return Value - Size * FMath::FloorToFloat(Value / Size + 0.5f);
+    }
+
+    // Shortest signed offset along one wrapping axis
+    static FORCEINLINE float WrapDelta(float From, float To, float Size)
+    {
+        return Wrap(To - From, Size);
+    }
+
+    // Normalize positions in place
+    static void NormalizeBatch(TArrayView<float> X, TArrayView<float> Y, float WorldWidth, float WorldHeight);
+
+    // OutDistances[i] = wrapped distance between A[i] and B[i]
+    static void PairwiseDistanceBatch(
+        TArrayView<const float> AX, TArrayView<const float> AY, TArrayView<const float> AZ,
+        TArrayView<const float> BX, TArrayView<const float> BY, TArrayView<const float> BZ,
+        float WorldWidth, float WorldHeight, TArrayView<float> OutDistances);
+
+    // OutDistances[i] = wrapped distance between Origin and P[i]
+    static void OneToManyDistanceBatch(
+        const FVector3f& Origin,
+        TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z,
+        float WorldWidth, float WorldHeight, TArrayView<float> OutDistances);
+
+    // Same as above but squared - skips the square root for range tests
+    static void OneToManyDistanceSquaredBatch(
+        const FVector3f& Origin,
+        TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z,
+        float WorldWidth, float WorldHeight, TArrayView<float> OutDistancesSquared);
+
+    // Unit direction of the shortest path from A[i] to B[i] (zero when A == B)
+    static void DirectionBatch(
+        TArrayView<const float> AX, TArrayView<const float> AY, TArrayView<const float> AZ,
+        TArrayView<const float> BX, TArrayView<const float> BY, TArrayView<const float> BZ,
+        float WorldWidth, float WorldHeight,
+        TArrayView<float> OutX, TArrayView<float> OutY, TArrayView<float> OutZ);
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+class UMeshComponent;
+class USkeletalMeshComponent;
+class UStaticMesh;
+
+// Map edges an object is close enough to for wrapped images to exist
+enum class EToroidalEdgeFlags : uint8
+{
+    None   = 0,
+    Left   = 1 << 0,
+    Right  = 1 << 1,
+    Bottom = 1 << 2,
+    Top    = 1 << 3
+};
+ENUM_CLASS_FLAGS(EToroidalEdgeFlags);
+
+// Render-only stand-in for one mesh component of the original actor
+struct FToroidalProxyElement
+{
+    TWeakObjectPtr<UMeshComponent> SourceComponent;
+
+    // Static meshes: batch key and instance slot in that batch
+    UStaticMesh* Mesh = nullptr;
+    int32 InstanceIndex = INDEX_NONE;
+
+    // Skeletal meshes: follower component driven by the source's pose
+    TWeakObjectPtr<USkeletalMeshComponent> SkeletalProxy;
+};
+
+// All proxy elements making up one wrapped image
+struct FToroidalGhostProxy
+{
+    TArray<FToroidalProxyElement> Elements;
+};
+
+// Wrapped images of one tracked object. Only one of the arrays is in use,
+// depending on the manager's ghost mode.
+struct FToroidalGhostSet
+{
+    // ActorCopy mode: pooled template copies
+    TArray<TWeakObjectPtr<AActor>> WrappedInstances;
+
+    // MeshProxy mode: one proxy per wrapped position
+    TArray<FToroidalGhostProxy> ProxyInstances;
+};
+
+/**
+ * Stable reference to a tracked object.
+ * Stays valid while the object is tracked, no matter how the storage is
+ * reshuffled; goes stale (never reused) once the object is removed.
+ */
+struct FToroidalHandle
+{
+    int32 Index = INDEX_NONE;
+    uint32 Generation = 0;
+
+    FToroidalHandle()
+    {
+    }
+
+    FToroidalHandle(int32 InIndex, uint32 InGeneration)
+        : Index(InIndex), Generation(InGeneration)
+    {
+    }
+
+    // True if the handle was ever assigned; use the store to check if it is still live
+    bool IsSet() const { return Index != INDEX_NONE; }
+
+    bool operator==(const FToroidalHandle& Other) const
+    {
+        return Index == Other.Index && Generation == Other.Generation;
+    }
+
+    bool operator!=(const FToroidalHandle& Other) const
+    {
+        return !(*this == Other);
+    }
+
+    friend uint32 GetTypeHash(const FToroidalHandle& Handle)
+    {
+        return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Generation));
+    }
+};
+
+/**
+ * Slot map holding every tracked toroidal object.
+ *
+ * Data lives in densely packed structure-of-arrays columns so per-frame
+ * passes touch contiguous memory. Handles point at a slot, and the slot
+ * points at the current dense index. Removal swaps the last element into
+ * the hole and pops, so it is O(1) and never invalidates other handles.
+ */
+class GAME_V0_API FToroidalObjectStore
+{
+public:
+    // Append a new object and return its handle
+    FToroidalHandle Add(AActor* Actor);
+
+    // Swap-and-pop removal. Returns false for stale handles.
+    bool Remove(FToroidalHandle Handle);
+
+    void Empty();
+
+    // Dense index of a live handle, INDEX_NONE if stale
+    int32 GetDenseIndex(FToroidalHandle Handle) const;
+
+    bool IsValid(FToroidalHandle Handle) const { return GetDenseIndex(Handle) != INDEX_NONE; }
+
+    // Handle of the object currently stored at a dense index
+    FToroidalHandle GetHandle(int32 DenseIndex) const;
+
+    int32 Num() const { return Actors.Num(); }
+
+    // --- Dense columns, all Num() long and indexed by dense index ---
+
+    TArray<TWeakObjectPtr<AActor>> Actors;
+
+    // Canonical (normalized) toroidal position
+    TArray<float> PositionX;
+    TArray<float> PositionY;
+    TArray<float> PositionZ;
+
+    TArray<EToroidalEdgeFlags> EdgeFlags;
+
+    TArray<FToroidalGhostSet> Ghosts;
+
+    // Binding on the actor's root TransformUpdated event
+    TArray<FDelegateHandle> TransformUpdatedHandles;
+
+    // Set while the object is queued for re-evaluation
+    TArray<bool> DirtyFlags;
+
+private:
+    struct FSlot
+    {
+        int32 DenseIndex = INDEX_NONE;
+        uint32 Generation = 0;
+    };
+
+    TArray<FSlot> Slots;
+    TArray<int32> FreeSlots;
+
+    // Slot owning each dense element (inverse of FSlot::DenseIndex)
+    TArray<int32> DenseToSlot;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+struct FToroidalCoordinate;
+
+/**
+ * Single entry stored in a grid cell
+ */
+struct FToroidalGridEntry
+{
+    TWeakObjectPtr<AActor> Actor;
+
+    // Normalized toroidal position the entry was last indexed at
+    FVector Position;
+
+    FToroidalGridEntry()
+        : Position(FVector::ZeroVector)
+    {
+    }
+
+    FToroidalGridEntry(AActor* InActor, const FVector& InPosition)
+        : Actor(InActor), Position(InPosition)
+    {
+    }
+};
+
+/**
+ * Uniform cell grid over the toroidal world.
+ * Cell indices are taken modulo the grid size, so a lookup that runs past
+ * one edge of the map continues on the opposite edge.
+ * Positions passed in must already be normalized (see NormalizeToroidalCoordinate).
+ */
+class GAME_V0_API FToroidalSpatialGrid
+{
+public:
+    FToroidalSpatialGrid();
+
+    // Rebuild the cell layout. Drops all indexed actors.
+    void Initialize(float InWorldWidth, float InWorldHeight, float InCellSize);
+
+    // Remove all actors, keep the cell layout
+    void Reset();
+
+    // Insert an actor or move it to the cell matching its new position
+    void AddOrUpdate(AActor* Actor, const FToroidalCoordinate& NormalizedPosition);
+
+    // Remove an actor (works for actors that were already destroyed)
+    void Remove(const TWeakObjectPtr<AActor>& Actor);
+
+    bool Contains(const TWeakObjectPtr<AActor>& Actor) const { return ActorCells.Contains(Actor); }
+
+    // Collect every entry in the cells overlapping a box around Center (seam aware).
+    // The result is a conservative candidate set - callers do the exact distance test.
+    void GatherCandidates(const FToroidalCoordinate& Center, float HalfExtentX, float HalfExtentY, TArray<FToroidalGridEntry>& OutEntries) const;
+
+    // Cell coordinates of a normalized position
+    FIntPoint GetCellCoords(const FToroidalCoordinate& NormalizedPosition) const;
+
+    // Flat cell index; CellX/CellY are wrapped modulo the grid size
+    int32 GetCellIndex(int32 CellX, int32 CellY) const;
+
+    int32 GetNumCellsX() const { return NumCellsX; }
+    int32 GetNumCellsY() const { return NumCellsY; }
+    float GetCellSizeX() const { return CellSizeX; }
+    float GetCellSizeY() const { return CellSizeY; }
+    int32 Num() const { return ActorCells.Num(); }
+
+private:
+    float WorldWidth;
+    float WorldHeight;
+    float CellSizeX;
+    float CellSizeY;
+    int32 NumCellsX;
+    int32 NumCellsY;
+
+    TArray<TArray<FToroidalGridEntry>> Cells;
+
+    // Cell each actor currently lives in
+    TMap<TWeakObjectPtr<AActor>, int32> ActorCells;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitAnimationBudgetSubsystem.generated.h"
+
+class AUnitBase;
+
+/**
+ * Paces unit skeletal mesh animation by significance.
+ *
+ * Every frame, on-screen units are ranked (selected first, then by toroidal
+ * distance to the local camera) and given an update rate: every frame near
+ * the camera, every few frames with interpolation further out. The cost of
+ * one update is measured: unit meshes (UUnitSkeletalMeshComponent) time
+ * their ticks, and the total over the updates planned for that frame gives a
+ * smoothed per-update cost. Once the ranked units use up BudgetMs, the rest
+ * drop to MaxTickRate. Selected units always run at full rate. Off-screen
+ * units only tick montages (set up in AUnitBase).
+ *
+ * Visual only, so it does nothing on a dedicated server.
+ */
+UCLASS()
+class GAME_V0_API UUnitAnimationBudgetSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Animation time per frame the units may use
+    UPROPERTY(BlueprintReadWrite, Category = "Animation Budget", meta = (ClampMin = "0.0"))
+    float BudgetMs = 2.0f;
+
+    // Cost of one full animation update of a unit until measurements come in
+    UPROPERTY(BlueprintReadWrite, Category = "Animation Budget", meta = (ClampMin = "0.001"))
+    float InitialUpdateCostMs = 0.05f;
+
+    // Closer than this: every frame
+    UPROPERTY(BlueprintReadWrite, Category = "Animation Budget", meta = (ClampMin = "0.0"))
+    float FullRateDistance = 3000.0f;
+
+    // Closer than this: every other frame. Beyond: MaxTickRate.
+    UPROPERTY(BlueprintReadWrite, Category = "Animation Budget", meta = (ClampMin = "0.0"))
+    float ReducedRateDistance = 8000.0f;
+
+    // Slowest rate, in frames per update
+    UPROPERTY(BlueprintReadWrite, Category = "Animation Budget", meta = (ClampMin = "2", ClampMax = "30"))
+    int32 MaxTickRate = 4;
+
+    // Game thread time unit meshes spent ticking last frame
+    UFUNCTION(BlueprintPure, Category = "Animation Budget")
+    float GetMeasuredCostMs() const { return MeasuredCostMs; }
+
+    // Smoothed measured cost of one full update
+    UFUNCTION(BlueprintPure, Category = "Animation Budget")
+    float GetUpdateCostMs() const { return UpdateCostMs; }
+
+    UFUNCTION(BlueprintPure, Category = "Animation Budget")
+    int32 GetNumThrottledUnits() const { return NumThrottledUnits; }
+
+    // Called by UUnitSkeletalMeshComponent after each tick
+    void AddMeasuredTime(double Milliseconds) { PendingMeasuredMs += Milliseconds; }
+
+private:
+    struct FRankedUnit
+    {
+        AUnitBase* Unit = nullptr;
+        float Distance = 0.0f;
+        bool bSelected = false;
+    };
+
+    static void ApplyTickRate(AUnitBase* Unit, int32 TickRate);
+
+    // Reused between frames
+    TArray<FRankedUnit> RankedUnits;
+
+    // Mesh tick time since our last tick, and the updates planned for it
+    double PendingMeasuredMs = 0.0;
+    float PlannedUpdates = 0.0f;
+
+    float MeasuredCostMs = 0.0f;
+    float UpdateCostMs = -1.0f;
+    int32 NumThrottledUnits = 0;
+};
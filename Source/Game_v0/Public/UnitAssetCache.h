@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "UnitAssetCache.generated.h"
+
+class AUnitBase;
+class URace_base;
+
+/**
+ * Shared loader for unit meshes and anim blueprints.
+ *
+ * Every asset is requested once: later requests for the same path join the
+ * one in flight and are all called back when it lands. The streamable handle
+ * is kept for the whole game instance, so assets stay resident between
+ * spawns instead of being unloaded and requested again.
+ */
+UCLASS()
+class GAME_V0_API UUnitAssetCache : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    // Cache of the object's game instance, if it has one
+    static UUnitAssetCache* Get(const UObject* WorldContextObject);
+
+    // Load through the cache when there is one, otherwise straight from the
+    // streamable manager (e.g. editor preview worlds). OnLoaded may run
+    // immediately if the asset is already in.
+    static void Load(const UObject* Requester, const FSoftObjectPath& Path, FSimpleDelegate OnLoaded);
+
+    void RequestAsset(const FSoftObjectPath& Path, FSimpleDelegate OnLoaded);
+
+    // Start loading everything a unit class may need (AUnitBase::GetAssetsToPreload)
+    void PreloadUnitClass(TSubclassOf<AUnitBase> UnitClass);
+
+    // All unit classes of a race
+    void PreloadRace(TSubclassOf<URace_base> RaceClass);
+
+    UFUNCTION(BlueprintPure, Category = "Unit Assets")
+    bool IsAssetLoaded(const FSoftObjectPath& Path) const;
+
+    UFUNCTION(BlueprintPure, Category = "Unit Assets")
+    int32 GetNumCachedAssets() const { return Assets.Num(); }
+
+private:
+    struct FCachedAsset
+    {
+        TSharedPtr<FStreamableHandle> Handle;
+        TArray<FSimpleDelegate> Waiters;
+        bool bLoaded = false;
+    };
+
+    void OnAssetLoaded(FSoftObjectPath Path);
+
+    TMap<FSoftObjectPath, FCachedAsset> Assets;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitAvoidanceSubsystem.generated.h"
+
+class UUnitMovementComponent;
+
+/**
+ * Local avoidance for all units in one batch (ORCA, optimal reciprocal
+ * collision avoidance).
+ *
+ * Each tick every registered unit is copied into flat arrays and bucketed in
+ * a uniform grid of NeighbourRadius cells. For every unit trying to move, the
+ * nearest MaxNeighbours units in the surrounding cells each give a half-plane
+ * of velocities that stay clear of them for TimeHorizon seconds; a small
+ * linear program picks the allowed velocity closest to the preferred one.
+ * Units are solved in parallel. Moving neighbours share the avoidance
+ * effort; idle ones are treated as obstacles that won't move.
+ *
+ * Neighbour offsets and grid cells wrap on a toroidal map.
+ */
+UCLASS()
+class GAME_V0_API UUnitAvoidanceSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void RegisterAgent(UUnitMovementComponent* Agent);
+    void UnregisterAgent(UUnitMovementComponent* Agent);
+
+    // Only units closer than this are considered; also the grid cell size
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Avoidance", meta = (ClampMin = "1.0"))
+    float NeighbourRadius = 500.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Avoidance", meta = (ClampMin = "1"))
+    int32 MaxNeighbours = 10;
+
+    // How far ahead (s) collisions are avoided. Longer is smoother but more cautious.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Avoidance", meta = (ClampMin = "0.1"))
+    float TimeHorizon = 1.5f;
+
+    UFUNCTION(BlueprintPure, Category = "Avoidance")
+    int32 GetNumAgents() const { return Agents.Num(); }
+
+private:
+    void GatherAgents();
+    void BuildGrid();
+    void SolveAgents(float DeltaTime);
+
+    // Cell of a (toroidal when wrapping) position
+    FIntPoint GetCell(float X, float Y) const;
+
+    UPROPERTY()
+    TArray<UUnitMovementComponent*> Agents;
+
+    TMap<UUnitMovementComponent*, int32> AgentIndices;
+
+    // Per-tick snapshot of the agents taking part, packed
+    TArray<UUnitMovementComponent*> Snapshot;
+    TArray<float> PositionX;
+    TArray<float> PositionY;
+    TArray<float> VelocityX;
+    TArray<float> VelocityY;
+    TArray<float> PreferredX;
+    TArray<float> PreferredY;
+    TArray<float> Radius;
+    TArray<float> MaxSpeed;
+    TArray<bool> bSteered;
+    TArray<float> OutVelocityX;
+    TArray<float> OutVelocityY;
+
+    // Grid: first snapshot index per cell, then a linked list through NextInCell
+    TMap<FIntPoint, int32> CellHeads;
+    TArray<int32> NextInCell;
+
+    bool bWrap = false;
+    float WorldWidth = 0.0f;
+    float WorldHeight = 0.0f;
+    FVector WorldCenter = FVector::ZeroVector;
+    int32 NumCellsX = 0;
+    int32 NumCellsY = 0;
+    float CellSizeX = 0.0f;
+    float CellSizeY = 0.0f;
+};
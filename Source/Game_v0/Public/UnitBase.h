@@ -8,6 +8,7 @@
 #include "UnitBase.generated.h"
 
 class AUnitSelectionManager;
+class ACustomPlayerState;
 
 // Add this enum to the base class
 UENUM(BlueprintType)
@@ -17,14 +18,51 @@ enum class EUnitSex : uint8
     Female  UMETA(DisplayName = "Female")
 };
 
+// One baked clip in a vertex animation texture
+USTRUCT(BlueprintType)
+struct FUnitVertexAnimClip
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd")
+    int32 StartFrame = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "1"))
+    int32 NumFrames = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "0.0"))
+    float FrameRate = 30.0f;
+};
+
+// How a unit looks when drawn as an instance in a crowd (see UUnitCrowdRenderSubsystem)
+USTRUCT(BlueprintType)
+struct FUnitCrowdVisual
+{
+    GENERATED_BODY()
+
+    // Static mesh baked from the skeletal mesh, with a vertex animation material
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowedClasses = "StaticMesh"))
+    TSoftObjectPtr<UStaticMesh> Mesh;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd")
+    FUnitVertexAnimClip Idle;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd")
+    FUnitVertexAnimClip Walk;
+
+    // Ground speed at which Walk plays at its own frame rate
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "1.0"))
+    float WalkReferenceSpeed = 200.0f;
+};
+
 UCLASS()
 class GAME_V0_API AUnitBase : public ACharacter
 {
     GENERATED_BODY()
 
 public:
-    // Sets default values for this character's properties
-    AUnitBase();
+    // Sets default values for this character's properties (with UUnitMovementComponent as movement)
+    AUnitBase(const FObjectInitializer& ObjectInitializer);
 
     // Appearance (soft reference, not directly loaded at startup)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance", meta = (AllowedClasses = "SkeletalMesh"))
@@ -59,9 +97,34 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
     EUnitSex UnitSex = EUnitSex::Male;
 
+    // May be demoted to a crowd row when far from every player's view.
+    // Off by default; the class also needs a crowd visual (GetCrowdVisual).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd")
+    bool bAllowCrowdSimulation = false;
+
+    // Stable id shared with UUnitCrowdSubsystem, INDEX_NONE until first demoted
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Crowd")
+    int32 CrowdUnitId = INDEX_NONE;
+
+    // Id in the UUnitLockstepSubsystem session, INDEX_NONE when not simulated there.
+    // Set by the server; lets a unit that replicates late find its slot.
+    UPROPERTY(ReplicatedUsing = OnRep_LockstepId, VisibleAnywhere, BlueprintReadOnly, Category = "Lockstep")
+    int32 LockstepId = INDEX_NONE;
+
+    // Soft assets the unit may load at runtime, for preloading (UUnitAssetCache)
+    virtual void GetAssetsToPreload(TArray<FSoftObjectPath>& OutPaths) const;
+
+    // Instanced look for a unit of this class and sex, or null to always draw the skeletal mesh
+    virtual const FUnitCrowdVisual* GetCrowdVisual(EUnitSex Sex) const { return nullptr; }
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void OnConstruction(const FTransform& Transform) override;
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    UFUNCTION()
+    void OnRep_LockstepId();
 
     // Selection state
     UPROPERTY()
@@ -75,8 +138,16 @@ protected:
     UPROPERTY()
     AUnitSelectionManager* SelectionManager;
 
+    // Parked in UUnitPoolSubsystem
+    UPROPERTY()
+    bool bIsPooled = false;
+
+    // Player state whose roster lists this unit (server)
+    TWeakObjectPtr<ACustomPlayerState> RosterOwner;
+
+    void LeaveRoster();
+
 public:
-    virtual void Tick(float DeltaTime) override;
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
     // Selection methods
@@ -93,9 +164,9 @@ public:
     UFUNCTION(BlueprintPure)
     bool GetIsMoving() const { return bIsMoving; }
 
-    // Team methods
+    // Team methods. Changing team moves the unit to the new team's roster.
     UFUNCTION(BlueprintCallable)
-    void SetTeamId(int32 NewTeamId) { TeamId = NewTeamId; }
+    void SetTeamId(int32 NewTeamId);
 
     UFUNCTION(BlueprintPure)
     int32 GetTeamId() const { return TeamId; }
@@ -111,6 +182,21 @@ public:
     UFUNCTION(BlueprintCallable)
     void InitializeUnit(int32 InTeamId, AUnitSelectionManager* InSelectionManager);
 
+    // Pool hooks (UUnitPoolSubsystem). Reset parks the unit inert and hidden;
+    // reinitialize turns it back into a fresh unit at Transform.
+    virtual void ResetForPool();
+    virtual void ReinitializeFromPool(const FTransform& Transform, int32 InTeamId, EUnitSex InSex, AUnitSelectionManager* InSelectionManager);
+
+    UFUNCTION(BlueprintPure)
+    bool IsPooled() const { return bIsPooled; }
+
+    // List the unit with its team's player state, if there is one yet (server)
+    void UpdateRoster();
+
+    // Refresh the animation variables; driven by UUnitTickSubsystem while active
+    UFUNCTION(BlueprintCallable)
+    void UpdateAnimationState();
+
     UFUNCTION(BlueprintCallable, Category = "Animation")
     float GetMovementSpeed() const { return MovementSpeed; }
     
@@ -126,9 +212,6 @@ public:
 protected:
     // Visual updates
     void UpdateSelectionVisual();
-    
-    UFUNCTION(BlueprintCallable)
-    void UpdateAnimationState();
 
     // Setup methods
     void SetupCollision();
@@ -139,6 +222,9 @@ protected:
     void LoadUnitMesh();
     void LoadSelectionMesh();
 
+    // Call after swapping a mesh so wrapped images pick it up
+    void MarkWrappedImagesDirty();
+
     // Animation properties
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Animation")
     float MovementSpeed = 10.0f;
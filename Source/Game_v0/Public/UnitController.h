@@ -3,12 +3,13 @@
 #include "CoreMinimal.h"
 #include "AIController.h"
 #include "Navigation/PathFollowingComponent.h"
+#include "UnitCommand.h"
 
 #include "UnitController.generated.h"
 
 
 class AUnitBase;
-struct FUnitCommand;
+class FUnitFlowField;
 
 
 UCLASS()
@@ -21,7 +22,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
+	virtual void OnPossess(APawn* InPawn) override;
 	
 
 	UPROPERTY()
@@ -42,17 +43,73 @@ protected:
 	UPROPERTY()
 	bool bUseDirectMovement = false;
 
+	// How far inside the map edge units stop before crossing a toroidal seam
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+	float SeamHandoffInset = 50.0f;
+
+	// Current leg ends at a seam; on arrival the unit is handed off to SeamEntryLocation
+	UPROPERTY()
+	bool bCrossingSeam = false;
+
+	UPROPERTY()
+	FVector SeamEntryLocation;
+
+	// Shared field of a group move; steers the unit until it reaches the goal region
+	TSharedPtr<const FUnitFlowField> FlowField;
+
+	// Path query queued with UUnitPathRequestSubsystem, 0 if none
+	uint32 PendingPathRequestId = 0;
+
+	// Set while we abort our own path following; OnMoveCompleted ignores that abort
+	bool bAbortingOwnMove = false;
+
+	// Order being carried out; None when idle or moved without a command
+	UPROPERTY()
+	FUnitCommand CurrentCommand;
+
+	// Orders to run after CurrentCommand, as a ring buffer. The next one is
+	// started from OnReachedDestination, so waiting costs nothing per frame.
+	static constexpr int32 MaxQueuedCommands = 16;
+	FUnitCommand QueuedCommands[MaxQueuedCommands];
+	int32 QueueHead = 0;
+	int32 NumQueuedCommands = 0;
+
 public:
 	// Movement commands
 
 	void MoveToLocation(FVector Destination);
 
+	// Walk the group's flow field to the goal region, then on to Destination (this unit's slot).
+	// Replaces the unit's orders with a Move to Destination, so shift-queued ones follow it.
+	void FollowFlowField(TSharedPtr<const FUnitFlowField> Field, const FVector& Destination);
+
+	// Per-frame movement update, called by UUnitTickSubsystem while the unit is active
+	void TickMovement(float DeltaTime);
+
+	// Result of a queued path query; null if no path was found. Stale ids are ignored.
+	void OnPathRequestFinished(uint32 RequestId, FNavPathSharedPtr Path);
+
+	uint32 GetPendingPathRequestId() const { return PendingPathRequestId; }
+
 
 	virtual void StopMovement() override;
 
-	// Command execution
+	// Command execution. Replaces the current order and the queue, unless the
+	// current order has a higher priority (then it is queued instead).
 	void ExecuteCommand(const FUnitCommand& Command);
 
+	// Run Command after everything already queued (shift-click). A higher
+	// priority than the current order interrupts it; it resumes afterwards.
+	void QueueCommand(const FUnitCommand& Command);
+
+	// Drop the current order and everything queued; movement in progress carries on
+	void ClearCommandQueue();
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumQueuedCommands() const { return NumQueuedCommands; }
+
+	const FUnitCommand& GetCurrentCommand() const { return CurrentCommand; }
+
 	// State queries
 	UFUNCTION(BlueprintPure)
 	bool IsMoving() const { return bIsMoving; }
@@ -72,4 +129,16 @@ protected:
 
 private:
 	void MoveDirectly(float DeltaTime);	
+	void MoveAlongFlowField(float DeltaTime);
+	void SteerTowards(const FVector& Direction, float DeltaTime);
+	void RequestPathTo(const FVector& Goal);
+	void HandOffAcrossSeam();
+	void TeleportAcrossSeam(const FVector& Entry);
+
+	void StartCommand(const FUnitCommand& Command);
+	void StartPatrolOrCommand(const FUnitCommand& Command);
+	void AdvanceCommandQueue();
+	bool PushCommandBack(const FUnitCommand& Command);
+	void PushCommandFront(const FUnitCommand& Command);
+	bool PopCommand(FUnitCommand& OutCommand);
 };
\ No newline at end of file
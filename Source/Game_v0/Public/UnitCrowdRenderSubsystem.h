@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitCrowdRenderSubsystem.generated.h"
+
+class AUnitBase;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+struct FUnitCrowdVisual;
+
+/**
+ * Draws distant units as vertex-animated instances.
+ *
+ * Unit classes opt in through AUnitBase::GetCrowdVisual (a static mesh baked
+ * from the skeletal mesh plus its idle/walk frame ranges). Units further than
+ * SkeletalDistance from the local camera hide their skeletal mesh and are
+ * drawn by one instanced static mesh per baked mesh instead; crowd tier rows
+ * (UUnitCrowdSubsystem, where it runs) are drawn the same way.
+ *
+ * Per-instance custom data the vertex animation material reads:
+ *   0: first frame of the clip, 1: number of frames,
+ *   2: time offset in seconds (desyncs neighbours), 3: frames per second.
+ */
+UCLASS()
+class GAME_V0_API UUnitCrowdRenderSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Closer than this a unit uses its skeletal mesh
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd Rendering", meta = (ClampMin = "0.0"))
+    float SkeletalDistance = 2500.0f;
+
+    // Crowd rows further than this aren't drawn at all
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd Rendering", meta = (ClampMin = "0.0"))
+    float MaxDrawDistance = 30000.0f;
+
+    UFUNCTION(BlueprintPure, Category = "Crowd Rendering")
+    int32 GetNumInstances() const { return NumInstances; }
+
+private:
+    // Instances gathered for one baked mesh this frame
+    struct FCrowdInstanceBatch
+    {
+        TArray<FTransform> Transforms;
+        TArray<float> CustomData;
+    };
+
+    // Queue an instance; returns false while the baked mesh is still loading
+    bool AddInstance(const FUnitCrowdVisual& Visual, const FTransform& Transform, float GroundSpeed, uint32 Seed);
+
+    void RequestMesh(const FUnitCrowdVisual& Visual);
+    UInstancedStaticMeshComponent* CreateComponent(UStaticMesh* Mesh);
+    void FlushBatch(UInstancedStaticMeshComponent* Component, const FCrowdInstanceBatch& Batch);
+
+    // Show or hide a unit's skeletal mesh, only touching it on change
+    static void SetSkeletalVisible(AUnitBase* Unit, bool bVisible);
+
+    UPROPERTY()
+    AActor* HostActor = nullptr;
+
+    UPROPERTY()
+    TMap<UStaticMesh*, UInstancedStaticMeshComponent*> Components;
+
+    TMap<UStaticMesh*, FCrowdInstanceBatch> Batches;
+
+    // Baked meshes with a load in flight
+    TSet<FSoftObjectPath> PendingMeshes;
+
+    int32 NumInstances = 0;
+};
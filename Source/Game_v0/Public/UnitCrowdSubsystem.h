@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitBase.h"
+#include "UnitCrowdSubsystem.generated.h"
+
+/**
+ * Crowd tier for units nobody is looking at.
+ *
+ * Distant units live as rows in contiguous arrays (one column per field) and
+ * are stepped in batch: no actor, no capsule, no controller, no pathfinding.
+ * Near a player's view frustum a row is promoted to a full AUnitBase; an
+ * actor that leaves every view (beyond DemoteRadius, so there is hysteresis)
+ * is demoted back into a row. Units are addressed by a stable id that
+ * survives both.
+ *
+ * Opt-in per unit (AUnitBase::bAllowCrowdSimulation), and only for classes
+ * with a crowd visual, since rows are drawn as instances or not at all.
+ *
+ * Runs on the server only; promoted actors replicate as usual.
+ */
+UCLASS()
+class GAME_V0_API UUnitCrowdSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Units within this ground distance of a view's footprint are promoted to actors
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "0.0"))
+    float PromoteRadius = 2000.0f;
+
+    // Actors beyond this from every footprint are demoted. Keep above PromoteRadius.
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "0.0"))
+    float DemoteRadius = 4000.0f;
+
+    // Caps the footprint of views that look at or over the horizon
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "0.0"))
+    float MaxViewDistance = 20000.0f;
+
+    // Seconds between tier passes; stepping rows happens every frame
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "0.0"))
+    float TierUpdateInterval = 0.25f;
+
+    // Spawns plus destroys per tier pass, to spread the cost over frames
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "1"))
+    int32 MaxTierChangesPerUpdate = 32;
+
+    // Rows closer than this to their goal have arrived
+    UPROPERTY(BlueprintReadWrite, Category = "Crowd", meta = (ClampMin = "0.0"))
+    float ArrivalRadius = 100.0f;
+
+    // Add a unit straight into the crowd tier. Returns its id.
+    UFUNCTION(BlueprintCallable, Category = "Crowd")
+    int32 AddCrowdUnit(TSubclassOf<AUnitBase> UnitClass, const FVector& Location, int32 TeamId);
+
+    UFUNCTION(BlueprintCallable, Category = "Crowd")
+    bool RemoveCrowdUnit(int32 UnitId);
+
+    // Send a crowd unit somewhere; it walks there in a straight line
+    UFUNCTION(BlueprintCallable, Category = "Crowd")
+    bool SetCrowdUnitGoal(int32 UnitId, const FVector& Goal);
+
+    // Turn an actor into a row (the actor is destroyed). Returns the id, or INDEX_NONE.
+    UFUNCTION(BlueprintCallable, Category = "Crowd")
+    int32 DemoteUnit(AUnitBase* Unit);
+
+    // Turn a row into an actor, carrying over stats and the current goal
+    UFUNCTION(BlueprintCallable, Category = "Crowd")
+    AUnitBase* PromoteUnit(int32 UnitId);
+
+    UFUNCTION(BlueprintPure, Category = "Crowd")
+    bool IsCrowdUnit(int32 UnitId) const { return IdToRow.Contains(UnitId); }
+
+    UFUNCTION(BlueprintPure, Category = "Crowd")
+    int32 GetNumCrowdUnits() const { return Ids.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Crowd")
+    int32 GetNumCrowdUnitsOfTeam(int32 TeamId) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Crowd")
+    bool GetCrowdUnitLocation(int32 UnitId, FVector& OutLocation) const;
+
+    // Visit every row, e.g. to draw it
+    void ForEachCrowdUnit(TFunctionRef<void(int32 UnitId, const FVector& Location, const FVector& Velocity, TSubclassOf<AUnitBase> UnitClass, EUnitSex Sex)> Visitor) const;
+
+private:
+    int32 AddRow(int32 UnitId, TSubclassOf<AUnitBase> UnitClass, const FVector& Location, int32 TeamId);
+    void RemoveRow(int32 Row);
+
+    void StepRows(float DeltaTime);
+    void UpdateTiers();
+
+    // Ground area under each player's view frustum (unwrapped)
+    void GatherViewFootprints(TArray<FBox2D>& OutFootprints) const;
+    float GetDistanceToNearestView(const FVector& Location, const TArray<FBox2D>& Footprints) const;
+
+    // Row columns. Row order is arbitrary; removal swaps the last row in.
+    TArray<int32> Ids;
+    TArray<float> PositionX;
+    TArray<float> PositionY;
+    TArray<float> PositionZ;
+    TArray<float> VelocityX;
+    TArray<float> VelocityY;
+    TArray<float> GoalX;
+    TArray<float> GoalY;
+    TArray<bool> HasGoal;
+    TArray<float> Speed;
+    TArray<int32> Teams;
+    TArray<int32> Ages;
+    TArray<float> Strengths;
+    TArray<float> SeeingRanges;
+    TArray<EUnitSex> Sexes;
+
+    UPROPERTY()
+    TArray<TSubclassOf<AUnitBase>> UnitClasses;
+
+    TMap<int32, int32> IdToRow;
+    int32 NextUnitId = 1;
+
+    float TimeSinceTierUpdate = 0.0f;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class UToroidalWorldManager;
+class ARecastNavMesh;
+
+/**
+ * One shared path for a whole group move order.
+ *
+ * A grid is laid around the goal, large enough to hold every unit of the
+ * group. Cells off the navmesh are blocked; the navmesh polygons under the
+ * grid are rasterized into it, rather than querying it cell by cell. A Dijkstra pass from the goal
+ * region fills in the walking cost of each cell, and each cell points to its
+ * cheapest neighbour. Units then just sample their cell's direction each
+ * frame: one search per order instead of one per unit.
+ *
+ * On a toroidal map the grid is laid out in offsets from the goal (shortest
+ * way round). When it would cover a whole axis it wraps along it instead, so
+ * routes across the seams come out of the same search.
+ */
+class GAME_V0_API FUnitFlowField
+{
+public:
+    // Lay out and solve the field. Fails if there is nothing to route.
+    bool Build(UWorld* World, const FVector& InGoal, float InGoalRadius, const TArray<FVector>& StartLocations, float InCellSize);
+
+    // Direction to walk from Location, or false if it is off the field or unreachable
+    bool SampleDirection(const FVector& Location, FVector& OutDirection) const;
+
+    // Within GoalRadius of the goal; units walk to their own slot from here
+    bool IsInGoalRegion(const FVector& Location) const;
+
+    const FVector& GetGoal() const { return Goal; }
+    int32 GetNumCells() const { return NumX * NumY; }
+
+    // Upper bound on cells; the cell size grows for very spread-out groups
+    static constexpr int32 MaxCells = 128 * 1024;
+
+    // Kept around the group so units can detour round obstacles
+    static constexpr float BoundsMargin = 2000.0f;
+
+private:
+    // Shortest offset from the goal (toroidal when on a torus)
+    FVector GetOffset(const FVector& Location) const;
+
+    // Cell holding a goal-relative offset, or INDEX_NONE off the field
+    int32 GetCellIndex(const FVector& Offset) const;
+
+    FVector GetCellOffset(int32 X, int32 Y) const;
+
+    // Clear Blocked for every cell whose centre lies on a navmesh polygon
+    void MarkWalkableCells(const ARecastNavMesh& NavMesh);
+
+    void Integrate();
+    void BuildDirections();
+
+    TWeakObjectPtr<const UToroidalWorldManager> ToroidalWorld;
+
+    FVector Goal = FVector::ZeroVector;
+    float GoalRadius = 0.0f;
+
+    int32 NumX = 0;
+    int32 NumY = 0;
+    float CellSizeX = 0.0f;
+    float CellSizeY = 0.0f;
+
+    // Offset of cell (0, 0)'s corner from the goal
+    FVector2D GridOrigin = FVector2D::ZeroVector;
+
+    // Neighbours wrap along an axis the grid covers completely
+    bool bWrapX = false;
+    bool bWrapY = false;
+
+    TArray<bool> Blocked;
+    TArray<float> Integration;
+    TArray<FVector2f> Directions;
+};
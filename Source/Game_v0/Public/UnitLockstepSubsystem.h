@@ -0,0 +1,325 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ToroidalFixedPoint.h"
+#include "UnitCommand.h"
+#include "UnitLockstepSubsystem.generated.h"
+
+class AUnitBase;
+class ABuildingPlayerController;
+
+// A unit order as sent between peers: target already in fixed point, so
+// every peer starts from the same bits
+USTRUCT()
+struct GAME_V0_API FLockstepCommand
+{
+    GENERATED_BODY()
+
+    // Index into the session roster
+    UPROPERTY()
+    int32 UnitId = INDEX_NONE;
+
+    UPROPERTY()
+    EUnitCommandType CommandType = EUnitCommandType::None;
+
+    UPROPERTY()
+    uint32 TargetX = 0;
+
+    UPROPERTY()
+    uint32 TargetY = 0;
+
+    UPROPERTY()
+    int32 TargetZ = 0;
+
+    UPROPERTY()
+    int32 Priority = 0;
+
+    // Shift-queued rather than replacing the unit's orders
+    UPROPERTY()
+    bool bQueued = false;
+
+    bool IsValid() const { return CommandType != EUnitCommandType::None; }
+};
+
+USTRUCT()
+struct GAME_V0_API FLockstepChecksum
+{
+    GENERATED_BODY()
+
+    // Turn the state was taken after; INDEX_NONE before the first one
+    UPROPERTY()
+    int32 Turn = INDEX_NONE;
+
+    UPROPERTY()
+    uint32 Units = 0;
+
+    UPROPERTY()
+    uint32 Resources = 0;
+};
+
+// One peer's orders for a turn, plus its latest checksum
+USTRUCT()
+struct GAME_V0_API FLockstepSubmission
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Turn = 0;
+
+    UPROPERTY()
+    TArray<FLockstepCommand> Commands;
+
+    UPROPERTY()
+    FLockstepChecksum Checksum;
+};
+
+// Roster entry: a unit and its starting sim state; its id is its position in the roster
+USTRUCT()
+struct GAME_V0_API FLockstepUnitStart
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    AUnitBase* Unit = nullptr;
+
+    UPROPERTY()
+    uint32 X = 0;
+
+    UPROPERTY()
+    uint32 Y = 0;
+
+    UPROPERTY()
+    int32 Z = 0;
+
+    // Fixed units per simulation step
+    UPROPERTY()
+    int32 Speed = 0;
+};
+
+// Every peer's orders for a turn, in the order all peers apply them
+USTRUCT()
+struct GAME_V0_API FLockstepTurn
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Turn = 0;
+
+    // Roster changes, applied before the orders. Joining units take the next
+    // free ids in order.
+    UPROPERTY()
+    TArray<int32> Leaves;
+
+    UPROPERTY()
+    TArray<FLockstepUnitStart> Joins;
+
+    UPROPERTY()
+    TArray<FLockstepCommand> Commands;
+};
+
+// Everything a peer needs to join a session
+USTRUCT()
+struct GAME_V0_API FLockstepStart
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FLockstepUnitStart> Units;
+
+    UPROPERTY()
+    int32 StepsPerSecond = 20;
+
+    UPROPERTY()
+    int32 StepsPerTurn = 4;
+
+    UPROPERTY()
+    int32 TurnDelay = 2;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLockstepDesync, int32, Turn);
+
+/**
+ * Deterministic lockstep mode for unit movement.
+ *
+ * Instead of replicating unit state, peers only exchange orders. Time is cut
+ * into turns of StepsPerTurn fixed simulation steps. Orders given during turn
+ * T are sent to the server for turn T + TurnDelay; once every player has
+ * submitted for a turn (an empty submission counts) the server sends the
+ * combined turn to everyone, and every peer applies it at the start of that
+ * turn. A peer that doesn't have the next turn yet waits.
+ *
+ * Units that come into play later (spawned, or back from the pool or a
+ * crowd) join at a turn boundary, and ones that leave play drop out, so
+ * every peer changes its roster at the same point.
+ *
+ * The simulation uses only integer fixed point (FToroidalFixedSpace) so all
+ * peers compute bit-identical positions; unit actors just show it,
+ * interpolated between steps. Units move straight to their targets, with no
+ * navmesh or avoidance. After each turn every peer hashes unit and resource
+ * state and sends it with its next submission; the server compares against
+ * its own and reports a desync.
+ *
+ * Resources are still replicated rather than simulated, so a resource
+ * mismatch only logs a warning: the client may just not have the update yet.
+ */
+UCLASS()
+class GAME_V0_API UUnitLockstepSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Server: take every unit in the world into a session and start it on all peers
+    UFUNCTION(BlueprintCallable, Category = "Lockstep")
+    bool StartLockstep();
+
+    // All peers: set up the simulation from the server's roster and settings
+    void BeginSession(const FLockstepStart& Start);
+
+    UFUNCTION(BlueprintPure, Category = "Lockstep")
+    bool IsRunning() const { return bRunning; }
+
+    // Roster id, or INDEX_NONE if the unit isn't simulated in lockstep
+    int32 GetUnitId(const AUnitBase* Unit) const;
+
+    // Local player's order; goes out with the next submission. False if the
+    // unit isn't part of the session.
+    bool SubmitCommand(AUnitBase* Unit, const FUnitCommand& Command, bool bQueue);
+
+    // Clients: a unit actor that wasn't there yet when its unit joined
+    void AttachActor(AUnitBase* Unit, int32 UnitId);
+
+    // All peers: the actor is going back to the pool or away. It stops showing
+    // its unit at once; the server sends the leave with the next turn.
+    void DetachActor(AUnitBase* Unit);
+
+    // Server: a player's submission arrived
+    void ReceiveSubmission(ABuildingPlayerController* From, const FLockstepSubmission& Submission);
+
+    // All peers: the server assembled a turn
+    void ReceiveTurn(const FLockstepTurn& Turn);
+
+    UFUNCTION(BlueprintPure, Category = "Lockstep")
+    int32 GetCurrentTurn() const { return CurrentTurn; }
+
+    // Waiting on a turn that hasn't arrived
+    UFUNCTION(BlueprintPure, Category = "Lockstep")
+    bool IsStalled() const { return bStalled; }
+
+    // Server: a peer's unit state differed from ours at some point
+    UFUNCTION(BlueprintPure, Category = "Lockstep")
+    bool HasDesynced() const { return bDesynced; }
+
+    // Server: fired for the first turn a peer's unit checksum differs
+    UPROPERTY(BlueprintAssignable, Category = "Lockstep")
+    FOnLockstepDesync OnDesync;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lockstep", meta = (ClampMin = "1"))
+    int32 StepsPerSecond = 20;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lockstep", meta = (ClampMin = "1"))
+    int32 StepsPerTurn = 4;
+
+    // Turns between giving an order and carrying it out; covers the round trip
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lockstep", meta = (ClampMin = "1"))
+    int32 TurnDelay = 2;
+
+    // Orders past this wait for the next submission
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lockstep", meta = (ClampMin = "1"))
+    int32 MaxCommandsPerTurn = 256;
+
+    // Fixed-point space when the map isn't a toroid with power-of-two sizes
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lockstep")
+    float FallbackWorldSize = 1048576.0f;
+
+private:
+    struct FSimUnit
+    {
+        TWeakObjectPtr<AUnitBase> Actor;
+        FToroidalFixedCoordinate Position;
+        FToroidalFixedCoordinate PreviousPosition;
+        FToroidalFixedCoordinate Goal;
+        bool bActive = true;
+        bool bHasGoal = false;
+        int32 Speed = 0;
+        FLockstepCommand Current;
+        TArray<FLockstepCommand> Queue;
+    };
+
+    // Server bookkeeping for a turn still being collected
+    struct FPendingTurn
+    {
+        TArray<TWeakObjectPtr<ABuildingPlayerController>> Submitted;
+        TArray<FLockstepCommand> Commands;
+    };
+
+    struct FRemoteChecksum
+    {
+        FString Peer;
+        FLockstepChecksum Checksum;
+    };
+
+    bool InitializeSpace();
+    void TakeOverActor(AUnitBase* Unit) const;
+    FLockstepUnitStart MakeUnitStart(AUnitBase* Unit) const;
+    void AddUnit(const FLockstepUnitStart& Entry);
+    void RemoveUnit(int32 UnitId);
+
+    void ApplyTurn(const FLockstepTurn& Turn);
+    void ApplyCommand(FSimUnit& Unit, const FLockstepCommand& Command) const;
+    void StartCommand(FSimUnit& Unit, const FLockstepCommand& Command) const;
+    void AdvanceCommands(FSimUnit& Unit) const;
+    void StepSimulation();
+    void FinishTurn();
+    void SendSubmission(int32 Turn);
+    void UpdatePresentation(float Alpha) const;
+
+    FLockstepChecksum ComputeChecksum(int32 Turn) const;
+
+    // Server
+    void TryDispatchTurns();
+    void CollectRosterChanges(FLockstepTurn& Turn);
+    int32 DispatchJoin(AUnitBase* Unit);
+    bool HasAllSubmissions(const FPendingTurn& Pending) const;
+    void CompareChecksum(const FRemoteChecksum& Remote);
+
+    FToroidalFixedSpace Space;
+    FVector WorldCenter = FVector::ZeroVector;
+
+    // Indexed by unit id
+    TArray<FSimUnit> Units;
+    TMap<FObjectKey, int32> UnitIds;
+
+    // Assembled turns not applied yet
+    TMap<int32, FLockstepTurn> ReadyTurns;
+
+    // Local orders not sent yet
+    TArray<FLockstepCommand> LocalCommands;
+
+    bool bRunning = false;
+    bool bStalled = false;
+    bool bDesynced = false;
+    int32 CurrentTurn = 0;
+    int32 StepInTurn = 0;
+    float Accumulator = 0.0f;
+    FLockstepChecksum LastChecksum;
+
+    // Server only
+    TArray<TWeakObjectPtr<ABuildingPlayerController>> Participants;
+    TMap<int32, FPendingTurn> PendingTurns;
+    int32 FirstOpenTurn = 0;
+    TMap<int32, FLockstepChecksum> OwnChecksums;
+    TArray<FRemoteChecksum> EarlyChecksums;
+
+    // Server: roster as already sent out, which may be ahead of Units
+    TArray<TWeakObjectPtr<AUnitBase>> DispatchedUnits;
+    TMap<FObjectKey, int32> DispatchedIds;
+
+    // Server: detached since the last dispatch, sent as leaves
+    TArray<int32> PendingLeaves;
+};
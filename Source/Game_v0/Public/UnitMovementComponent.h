@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "UnitMovementComponent.generated.h"
+
+/**
+ * Character movement for units, steered by UUnitAvoidanceSubsystem.
+ *
+ * Each update the velocity the unit wants (from its path or direct input) is
+ * kept as its preferred velocity; the avoidance pass reads those for every
+ * moving unit and hands back a collision-free velocity, which replaces the
+ * horizontal velocity on the next update. Units don't block each other
+ * physically, so this is what keeps them apart.
+ */
+UCLASS()
+class GAME_V0_API UUnitMovementComponent : public UCharacterMovementComponent
+{
+    GENERATED_BODY()
+
+public:
+    UUnitMovementComponent();
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration) override;
+
+    // Take part in UUnitAvoidanceSubsystem; other units still avoid this one either way
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Avoidance")
+    bool bUseUnitAvoidance = true;
+
+    // Horizontal velocity the unit would have moved at without avoidance
+    const FVector& GetPreferredVelocity() const { return PreferredVelocity; }
+
+    void SetAvoidanceVelocity(const FVector& InVelocity);
+
+private:
+    FVector PreferredVelocity = FVector::ZeroVector;
+    FVector AvoidanceVelocity = FVector::ZeroVector;
+
+    // Frame the avoidance velocity was computed on; older ones are ignored
+    uint64 AvoidanceFrame = 0;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NavigationData.h"
+#include "UnitPathRequestSubsystem.generated.h"
+
+class AUnitController;
+
+/**
+ * Queue for unit path queries.
+ *
+ * Controllers don't pathfind when they are given an order; they queue a
+ * request here and get their path back a frame or so later. Each tick the
+ * queue is drained in one batch: requests whose start and goal fall in the
+ * same ShareCellSize cells (a group ordered together) are merged, and one
+ * async query on the navigation system's worker runs per merged group.
+ * Every member then follows the shared corridor with its own start and goal
+ * (its formation slot) swapped in at the ends.
+ */
+UCLASS()
+class GAME_V0_API UUnitPathRequestSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Queue a path for Controller. The result comes back through
+    // AUnitController::OnPathRequestFinished with the returned id.
+    uint32 RequestPath(AUnitController* Controller, const FVector& Start, const FVector& Goal);
+
+    // Requests from and to the same cells of this size share one query
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (ClampMin = "1.0"))
+    float ShareCellSize = 400.0f;
+
+    // Async queries started per tick; anything over waits for the next one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (ClampMin = "1"))
+    int32 MaxQueriesPerTick = 32;
+
+    UFUNCTION(BlueprintPure, Category = "Pathfinding")
+    int32 GetNumQueuedRequests() const { return Queue.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Pathfinding")
+    int32 GetNumQueriesInFlight() const { return InFlight.Num(); }
+
+private:
+    struct FPathRequest
+    {
+        TWeakObjectPtr<AUnitController> Controller;
+        uint32 RequestId = 0;
+        FVector Start = FVector::ZeroVector;
+        FVector Goal = FVector::ZeroVector;
+    };
+
+    // One query; Members[0] is the request it was made for
+    struct FPathRequestGroup
+    {
+        TArray<FPathRequest> Members;
+    };
+
+    bool StartQuery(FPathRequestGroup&& Group);
+    void OnQueryFinished(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+    // The shared path, bent at both ends onto Request's own start and goal
+    FNavPathSharedPtr MakeMemberPath(const FNavPathSharedPtr& SharedPath, const FPathRequest& Request) const;
+
+    static void Finish(const FPathRequest& Request, FNavPathSharedPtr Path);
+
+    TArray<FPathRequest> Queue;
+    TMap<uint32, FPathRequestGroup> InFlight;
+
+    uint32 NextRequestId = 1;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitBase.h"
+#include "UnitPoolSubsystem.generated.h"
+
+// Idle units of one class
+USTRUCT()
+struct FUnitPoolEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<AUnitBase*> Units;
+};
+
+/**
+ * Recycles unit actors instead of destroying and respawning them.
+ *
+ * Released units are parked hidden, without collision and out of every unit
+ * system (AUnitBase::ResetForPool), keeping their components, loaded meshes
+ * and AI controller. Acquiring one only repositions and reinitializes it
+ * (AUnitBase::ReinitializeFromPool). Prewarm ahead of reinforcement waves to
+ * pay for construction at a quiet moment.
+ */
+UCLASS()
+class GAME_V0_API UUnitPoolSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+
+    // Idle units kept per class; releases beyond this are destroyed
+    UPROPERTY(BlueprintReadWrite, Category = "Unit Pool", meta = (ClampMin = "0"))
+    int32 MaxPooledPerClass = 256;
+
+    // Spawn units of a class until Count are idle in the pool
+    UFUNCTION(BlueprintCallable, Category = "Unit Pool")
+    void Prewarm(TSubclassOf<AUnitBase> UnitClass, int32 Count);
+
+    // A ready unit at Transform, from the pool when possible
+    UFUNCTION(BlueprintCallable, Category = "Unit Pool")
+    AUnitBase* AcquireUnit(TSubclassOf<AUnitBase> UnitClass, const FTransform& Transform, int32 TeamId, EUnitSex Sex,
+                           AUnitSelectionManager* SelectionManager = nullptr);
+
+    // Give a unit back instead of destroying it
+    UFUNCTION(BlueprintCallable, Category = "Unit Pool")
+    void ReleaseUnit(AUnitBase* Unit);
+
+    UFUNCTION(BlueprintPure, Category = "Unit Pool")
+    int32 GetNumPooled(TSubclassOf<AUnitBase> UnitClass) const;
+
+private:
+    AUnitBase* SpawnUnit(UClass* UnitClass, const FTransform& Transform, int32 TeamId, EUnitSex Sex);
+
+    UPROPERTY()
+    TMap<UClass*, FUnitPoolEntry> Pools;
+};
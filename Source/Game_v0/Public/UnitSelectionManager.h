@@ -10,6 +10,15 @@ class AUnitController;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSelectionChanged, const TArray<AUnitBase*>&, SelectedUnits);
 
+// Layout of a group move, facing the direction of travel
+UENUM(BlueprintType)
+enum class EUnitFormationShape : uint8
+{
+    Box     UMETA(DisplayName = "Box"),
+    Line    UMETA(DisplayName = "Line"),
+    Wedge   UMETA(DisplayName = "Wedge")
+};
+
 UCLASS()
 class GAME_V0_API AUnitSelectionManager : public AActor
 {
@@ -30,6 +39,31 @@ protected:
     UPROPERTY()
     class APlayerController* OwnerPC;
 
+    // Big groups share one flow field for a move instead of pathfinding per unit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    bool bUseFlowFieldForGroups = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement", meta = (ClampMin = "2"))
+    int32 FlowFieldMinGroupSize = 8;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement", meta = (ClampMin = "25.0"))
+    float FlowFieldCellSize = 200.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Formation")
+    EUnitFormationShape FormationShape = EUnitFormationShape::Box;
+
+    // Distance between neighbouring slots
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Formation", meta = (ClampMin = "1.0"))
+    float FormationSpacing = 150.0f;
+
+    // Widest rank of a Line; longer lines continue in ranks behind
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Formation", meta = (ClampMin = "1"))
+    int32 MaxLineWidth = 40;
+
+    // Improvement passes over the greedy slot assignment (pairwise swaps)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Formation", meta = (ClampMin = "0"))
+    int32 FormationRefinePasses = 4;
+
 public:
     // Selection events
     UPROPERTY(BlueprintAssignable)
@@ -49,11 +83,12 @@ public:
     void DeselectAll();
 
     // Command methods
+    // bQueue runs the command after each unit's current orders (shift-click)
     UFUNCTION(BlueprintCallable)
-    void IssueCommand(const FUnitCommand& Command);
+    void IssueCommand(const FUnitCommand& Command, bool bQueue = false);
 
     UFUNCTION(BlueprintCallable)
-    void IssueMoveCommand(FVector TargetLocation);
+    void IssueMoveCommand(FVector TargetLocation, bool bQueue = false);
 
     UFUNCTION(BlueprintCallable)
     void IssueStopCommand();
@@ -78,6 +113,19 @@ protected:
     void UpdateSelectionVisuals();
     void ValidateSelectedUnits();
 
-    // Formation helpers for multiple unit movement
-    TArray<FVector> CalculateFormationPositions(FVector CenterLocation, int32 UnitCount);
+    // Formation helpers for multiple unit movement. Facing is the direction of travel.
+    TArray<FVector> CalculateFormationPositions(FVector CenterLocation, int32 UnitCount, const FVector& Facing);
+
+    // Slot offsets in formation space (X forward, Y right) for FormationShape
+    void GetFormationOffsets(int32 UnitCount, TArray<FVector2D>& OutOffsets) const;
+
+    // Direction from the selected units to a target (shortest way on a torus)
+    FVector GetGroupFacing(const FVector& TargetLocation) const;
+
+    // Reorder Slots so Slots[i] is the one for SelectedUnits[i], keeping the
+    // total walking distance low: greedy nearest pairs, then pairwise swaps
+    TArray<FVector> AssignFormationSlots(const FVector& TargetLocation, const TArray<FVector>& Slots) const;
+
+    // Build one flow field to the formation and send every unit along it. False if it couldn't be built.
+    bool IssueFlowFieldMove(const FVector& TargetLocation, const TArray<FVector>& FormationPositions);
 };
\ No newline at end of file
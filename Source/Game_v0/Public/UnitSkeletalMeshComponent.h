@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "UnitSkeletalMeshComponent.generated.h"
+
+class UUnitAnimationBudgetSubsystem;
+
+/**
+ * Skeletal mesh for units. Times its own tick (animation update and
+ * whatever evaluation runs on the game thread) and reports it to
+ * UUnitAnimationBudgetSubsystem, so the budget works from measured cost.
+ */
+UCLASS()
+class GAME_V0_API UUnitSkeletalMeshComponent : public USkeletalMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    virtual void BeginPlay() override;
+    virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+    TWeakObjectPtr<UUnitAnimationBudgetSubsystem> AnimationBudget;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitTickSubsystem.generated.h"
+
+class AUnitBase;
+class AUnitController;
+
+/**
+ * One tick for every unit in the world.
+ *
+ * AUnitBase and AUnitController don't tick themselves. Units register here on
+ * BeginPlay and are only visited while they are active (ordered to move, or
+ * still coasting to a stop); idle units cost nothing per frame. Active units
+ * and their controllers sit in parallel packed arrays.
+ *
+ * All of it shows up as STAT_UnitTick ("stat game").
+ */
+UCLASS()
+class GAME_V0_API UUnitTickSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Refresh animation variables for 1/N of the active units each frame.
+    // 1 updates everyone every frame. Movement is never sliced.
+    UPROPERTY(BlueprintReadWrite, Category = "Units", meta = (ClampMin = "1"))
+    int32 AnimationStateSlices = 1;
+
+    void RegisterUnit(AUnitBase* Unit);
+    void UnregisterUnit(AUnitBase* Unit);
+
+    // Start ticking a unit (it was given something to do). It drops back to
+    // idle by itself once it has stopped.
+    void ActivateUnit(AUnitBase* Unit);
+
+    const TSet<AUnitBase*>& GetRegisteredUnits() const { return RegisteredUnits; }
+
+    UFUNCTION(BlueprintPure, Category = "Units")
+    int32 GetNumRegisteredUnits() const { return RegisteredUnits.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Units")
+    int32 GetNumActiveUnits() const { return ActiveUnits.Num(); }
+
+private:
+    void RemoveActiveAt(int32 Index);
+
+    UPROPERTY()
+    TSet<AUnitBase*> RegisteredUnits;
+
+    // Parallel arrays, packed; ActiveIndices maps a unit to its slot
+    UPROPERTY()
+    TArray<AUnitBase*> ActiveUnits;
+
+    UPROPERTY()
+    TArray<AUnitController*> ActiveControllers;
+
+    TMap<AUnitBase*, int32> ActiveIndices;
+
+    uint32 FrameCounter = 0;
+};
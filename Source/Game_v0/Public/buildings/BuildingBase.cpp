@@ -3,6 +3,8 @@
 #include "BuildingBase.h"
 #include "Components/StaticMeshComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "CustomPlayerState.h"
+#include "Toroid.h"
 
 // Sets default values
 ABuildingBase::ABuildingBase()
@@ -44,6 +46,16 @@ void ABuildingBase::BeginPlay()
     CurrentHealth = MaxHealth;
 }
 
+void ABuildingBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (HasAuthority() && OwningPlayer)
+    {
+        OwningPlayer->UnregisterBuilding(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void ABuildingBase::Tick(float DeltaTime)
 {
@@ -55,6 +67,12 @@ void ABuildingBase::SetBuildingMesh(UStaticMesh* NewMesh)
     if (NewMesh)
     {
         BuildingMesh->SetStaticMesh(NewMesh);
+
+        // Mesh proxies across the world edge copy the new mesh on their next update
+        if (UToroidalWorldManager* ToroidalWorld = UToroidalWorldManager::Get(this))
+        {
+            ToroidalWorld->MarkActorDirty(this);
+        }
     }
 }
 
@@ -185,9 +203,19 @@ void ABuildingBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 }
 void ABuildingBase::SetOwningPlayer(ACustomPlayerState* InOwningPlayer)
 {
-    if (HasAuthority())
+    if (HasAuthority() && OwningPlayer != InOwningPlayer)
     {
+        if (OwningPlayer)
+        {
+            OwningPlayer->UnregisterBuilding(this);
+        }
+
         OwningPlayer = InOwningPlayer;
+
+        if (OwningPlayer)
+        {
+            OwningPlayer->RegisterBuilding(this);
+        }
     }
 }
 